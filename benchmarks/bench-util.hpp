@@ -0,0 +1,159 @@
+#ifndef BVH11_BENCH_UTIL_HPP_
+#define BVH11_BENCH_UTIL_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace benchutil
+{
+    /// \brief Run the function repeatedly and return the fastest elapsed time in seconds.
+    template <typename Function>
+    double measure_seconds(Function function, int num_repeats = 5)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < num_repeats; ++i)
+        {
+            const auto begin = std::chrono::steady_clock::now();
+            function();
+            const auto end = std::chrono::steady_clock::now();
+
+            best = std::min(best, std::chrono::duration<double>(end - begin).count());
+        }
+        return best;
+    }
+
+    inline std::size_t get_file_size(const std::string& file_path)
+    {
+        std::ifstream ifs(file_path, std::ios::binary | std::ios::ate);
+        return ifs.is_open() ? static_cast<std::size_t>(ifs.tellg()) : 0;
+    }
+
+    /// \brief Create a long synthetic BVH file by repeating the motion frames of an existing BVH file.
+    inline void create_tiled_bvh_file(const std::string& source_path, const std::string& output_path, int num_frames)
+    {
+        std::ifstream ifs(source_path);
+        assert(ifs.is_open() && "Failed to open the source file.");
+
+        std::string              line;
+        std::string              header;
+        std::vector<std::string> frame_lines;
+        bool                     is_in_motion = false;
+        while (std::getline(ifs, line))
+        {
+            if (!is_in_motion)
+            {
+                if (line.compare(0, 7, "Frames:") == 0)
+                {
+                    continue;
+                }
+                if (line.compare(0, 11, "Frame Time:") == 0)
+                {
+                    header += "Frames: " + std::to_string(num_frames) + "\n";
+                    header += line + "\n";
+                    is_in_motion = true;
+                    continue;
+                }
+                header += line + "\n";
+            }
+            else if (!line.empty())
+            {
+                frame_lines.push_back(line);
+            }
+        }
+        assert(!frame_lines.empty() && "Could not find any frame.");
+
+        std::ofstream ofs(output_path);
+        ofs << header;
+        for (int frame = 0; frame < num_frames; ++frame)
+        {
+            ofs << frame_lines[frame % frame_lines.size()] << "\n";
+        }
+    }
+
+    /// \brief Create a synthetic BVH file with random motion.
+    /// \details The root joint has six channels and the other joints have three rotation channels. The non-root
+    ///          joints form chains of the specified length hanging from the root joint.
+    /// \param num_joints Number of the joints including the root joint.
+    /// \param chain_length Number of the joints in each chain (i.e., the depth of the hierarchy minus one).
+    inline void create_synthetic_bvh_file(const std::string& output_path,
+                                          int                num_joints,
+                                          int                chain_length,
+                                          int                num_frames,
+                                          unsigned           seed = 0)
+    {
+        assert(num_joints >= 1 && chain_length >= 1);
+
+        std::ofstream ofs(output_path);
+        assert(ofs.is_open() && "Failed to open the output file.");
+
+        ofs << "HIERARCHY\n";
+        ofs << "ROOT Root\n{\n";
+        ofs << "\tOFFSET 0.0 0.0 0.0\n";
+        ofs << "\tCHANNELS 6 Xposition Yposition Zposition Zrotation Xrotation Yrotation\n";
+
+        int joint_index = 1;
+        while (joint_index < num_joints)
+        {
+            const int length = std::min(chain_length, num_joints - joint_index);
+            for (int depth = 1; depth <= length; ++depth, ++joint_index)
+            {
+                const std::string indent(depth, '\t');
+                ofs << indent << "JOINT Joint" << joint_index << "\n";
+                ofs << indent << "{\n";
+                ofs << indent << "\tOFFSET 0.0 1.5 0.0\n";
+                ofs << indent << "\tCHANNELS 3 Zrotation Xrotation Yrotation\n";
+            }
+            ofs << std::string(length + 1, '\t') << "End Site\n";
+            ofs << std::string(length + 1, '\t') << "{\n";
+            ofs << std::string(length + 2, '\t') << "OFFSET 0.0 1.0 0.0\n";
+            ofs << std::string(length + 1, '\t') << "}\n";
+            for (int depth = length; depth >= 1; --depth)
+            {
+                ofs << std::string(depth, '\t') << "}\n";
+            }
+        }
+        ofs << "}\n";
+
+        const int num_channels = 6 + 3 * (num_joints - 1);
+
+        ofs << "MOTION\n";
+        ofs << "Frames: " << num_frames << "\n";
+        ofs << "Frame Time: 0.0083333\n";
+
+        std::mt19937                     engine(seed);
+        std::uniform_real_distribution<> distribution(-180.0, 180.0);
+
+        char buffer[32];
+        for (int frame = 0; frame < num_frames; ++frame)
+        {
+            std::string line;
+            for (int channel = 0; channel < num_channels; ++channel)
+            {
+                std::snprintf(buffer, sizeof(buffer), channel == 0 ? "%.4f" : " %.4f", distribution(engine));
+                line += buffer;
+            }
+            ofs << line << "\n";
+        }
+    }
+
+    inline void print_result(const std::string& label, double seconds, std::size_t num_bytes)
+    {
+        const double megabytes = static_cast<double>(num_bytes) / (1024.0 * 1024.0);
+
+        std::ostringstream oss;
+        oss.precision(3);
+        oss << std::fixed << label << ": " << 1000.0 * seconds << " ms (" << megabytes / seconds << " MB/s)";
+        std::cout << oss.str() << std::endl;
+    }
+} // namespace benchutil
+
+#endif
@@ -0,0 +1,57 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    const int num_repetitions = (argc >= 2) ? std::atoi(argv[1]) : 100;
+
+    const std::vector<std::string> file_paths = {
+        "131_01.bvh",
+        "131_02.bvh",
+        "131_03.bvh",
+    };
+
+    bvh11::LoadOptions text_options;
+    text_options.use_memory_mapping = true;
+
+    bvh11::LoadOptions binary_stream_options;
+    binary_stream_options.format = bvh11::FileFormat::binary;
+
+    bvh11::LoadOptions binary_mapping_options;
+    binary_mapping_options.format             = bvh11::FileFormat::binary;
+    binary_mapping_options.use_memory_mapping = true;
+
+    for (const std::string& file_path : file_paths)
+    {
+        // Scale up the bundled file by repeating its frames
+        const int         num_frames  = bvh11::BvhObject(file_path).frames() * num_repetitions;
+        const std::string text_path   = "binary_load_benchmark.bvh";
+        const std::string binary_path = "binary_load_benchmark.bvhb";
+        benchutil::create_tiled_bvh_file(file_path, text_path, num_frames);
+        bvh11::BvhObject(text_path).WriteBinaryFile(binary_path);
+
+        const std::size_t text_size   = benchutil::get_file_size(text_path);
+        const std::size_t binary_size = benchutil::get_file_size(binary_path);
+
+        const double text_seconds =
+            benchutil::measure_seconds([&]() { bvh11::BvhObject bvh(text_path, text_options); }, 3);
+        const double binary_stream_seconds =
+            benchutil::measure_seconds([&]() { bvh11::BvhObject bvh(binary_path, binary_stream_options); }, 3);
+        const double binary_mapping_seconds =
+            benchutil::measure_seconds([&]() { bvh11::BvhObject bvh(binary_path, binary_mapping_options); }, 3);
+
+        const std::string label = file_path + " x" + std::to_string(num_repetitions);
+        benchutil::print_result(label + " [text]", text_seconds, text_size);
+        benchutil::print_result(label + " [binary, stream]", binary_stream_seconds, binary_size);
+        benchutil::print_result(label + " [binary, mmap]", binary_mapping_seconds, binary_size);
+        std::cout << "  speed-up: x" << text_seconds / binary_mapping_seconds << std::endl;
+
+        std::remove(text_path.c_str());
+        std::remove(binary_path.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <bench-util.hpp>
+#include <benchmark/benchmark.h>
+#include <bvh11.hpp>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace
+{
+    /// \brief Synthetic BVH files created on demand and removed at exit.
+    class SyntheticFiles
+    {
+    public:
+        ~SyntheticFiles()
+        {
+            for (const auto& entry : objects_)
+            {
+                std::remove(entry.first.c_str());
+            }
+        }
+
+        /// \brief Get the path to the file of the scale given by the arguments (#joints, depth, #frames).
+        std::string GetFilePath(const benchmark::State& state)
+        {
+            const int num_joints = static_cast<int>(state.range(0));
+            const int depth      = static_cast<int>(state.range(1));
+            const int num_frames = static_cast<int>(state.range(2));
+
+            const std::string file_path = "bvh11_bench_" + std::to_string(num_joints) + "_" + std::to_string(depth) +
+                                          "_" + std::to_string(num_frames) + ".bvh";
+            if (objects_.find(file_path) == objects_.end())
+            {
+                benchutil::create_synthetic_bvh_file(file_path, num_joints, depth, num_frames);
+                objects_[file_path] = nullptr;
+            }
+            return file_path;
+        }
+
+        /// \brief Get the object loaded from the file of the scale given by the arguments, which is loaded once.
+        const bvh11::BvhObject& GetObject(const benchmark::State& state)
+        {
+            const std::string file_path = GetFilePath(state);
+
+            std::unique_ptr<bvh11::BvhObject>& object = objects_[file_path];
+            if (object == nullptr)
+            {
+                object.reset(new bvh11::BvhObject(file_path));
+            }
+            return *object;
+        }
+
+    private:
+        std::map<std::string, std::unique_ptr<bvh11::BvhObject>> objects_;
+    };
+
+    SyntheticFiles synthetic_files;
+
+    /// \brief Register the scales as (#joints, depth of the chains, #frames).
+    void apply_scales(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"joints", "depth", "frames"});
+        benchmark->Args({31, 5, 1000});
+        benchmark->Args({101, 10, 5000});
+        benchmark->Args({301, 30, 5000});
+        benchmark->Args({101, 100, 1000});
+    }
+
+    void ReadBvhFile(benchmark::State& state)
+    {
+        const std::string file_path = synthetic_files.GetFilePath(state);
+        for (auto _ : state)
+        {
+            const bvh11::BvhObject bvh(file_path);
+            benchmark::DoNotOptimize(bvh.motion().data());
+        }
+        state.SetBytesProcessed(state.iterations() * benchutil::get_file_size(file_path));
+    }
+
+    void GetTransformation(benchmark::State& state)
+    {
+        const bvh11::BvhObject& bvh    = synthetic_files.GetObject(state);
+        const auto              joints = bvh.GetJointList();
+
+        int frame = 0;
+        for (auto _ : state)
+        {
+            for (const auto& joint : joints)
+            {
+                benchmark::DoNotOptimize(bvh.GetTransformation(joint, frame));
+            }
+            frame = (frame + 1) % bvh.frames();
+        }
+        state.SetItemsProcessed(state.iterations() * joints.size());
+    }
+
+    void GetTransformationRelativeToParent(benchmark::State& state)
+    {
+        const bvh11::BvhObject& bvh    = synthetic_files.GetObject(state);
+        const auto              joints = bvh.GetJointList();
+
+        int frame = 0;
+        for (auto _ : state)
+        {
+            for (const auto& joint : joints)
+            {
+                benchmark::DoNotOptimize(bvh.GetTransformationRelativeToParent(joint, frame));
+            }
+            frame = (frame + 1) % bvh.frames();
+        }
+        state.SetItemsProcessed(state.iterations() * joints.size());
+    }
+
+    void GetJointList(benchmark::State& state)
+    {
+        const bvh11::BvhObject& bvh = synthetic_files.GetObject(state);
+        for (auto _ : state)
+        {
+            const auto joints = bvh.GetJointList();
+            benchmark::DoNotOptimize(joints.data());
+        }
+        state.SetItemsProcessed(state.iterations() * bvh.GetJointList().size());
+    }
+
+    void WriteBvhFile(benchmark::State& state)
+    {
+        const bvh11::BvhObject& bvh         = synthetic_files.GetObject(state);
+        const std::string       output_path = "bvh11_bench_output.bvh";
+        for (auto _ : state)
+        {
+            bvh.WriteBvhFile(output_path);
+        }
+        state.SetBytesProcessed(state.iterations() * benchutil::get_file_size(output_path));
+        std::remove(output_path.c_str());
+    }
+
+    void ResizeFrames(benchmark::State& state)
+    {
+        // Grow the clip to twice its length and shrink it back
+        bvh11::BvhObject bvh        = synthetic_files.GetObject(state);
+        const int        num_frames = bvh.frames();
+        for (auto _ : state)
+        {
+            bvh.ResizeFrames(2 * num_frames);
+            bvh.ResizeFrames(num_frames);
+            benchmark::DoNotOptimize(bvh.motion().data());
+        }
+        state.SetBytesProcessed(state.iterations() * bvh.motion().size() * sizeof(double));
+    }
+} // namespace
+
+BENCHMARK(ReadBvhFile)->Apply(apply_scales)->Unit(benchmark::kMillisecond);
+BENCHMARK(GetTransformation)->Apply(apply_scales)->Unit(benchmark::kMicrosecond);
+BENCHMARK(GetTransformationRelativeToParent)->Apply(apply_scales)->Unit(benchmark::kMicrosecond);
+BENCHMARK(GetJointList)->Apply(apply_scales);
+BENCHMARK(WriteBvhFile)->Apply(apply_scales)->Unit(benchmark::kMillisecond);
+BENCHMARK(ResizeFrames)->Apply(apply_scales)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,57 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <iostream>
+
+namespace
+{
+    void print_throughput(const std::string& label, double seconds, double num_evaluations)
+    {
+        std::cout << "  " << label << ": " << 1e-6 * num_evaluations / seconds << " M frames*joints/s" << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    const std::vector<std::string> file_paths = {
+        "131_01.bvh",
+        "131_02.bvh",
+        "131_03.bvh",
+    };
+
+    for (const std::string& file_path : file_paths)
+    {
+        const bvh11::BvhObject bvh(file_path);
+
+        const int    num_joints      = static_cast<int>(bvh.GetJointList().size());
+        const double num_evaluations = static_cast<double>(bvh.frames()) * num_joints;
+
+        // Evaluate the frames one by one
+        double               checksum_per_frame = 0.0;
+        bvh11::TransformList transforms;
+        const double         per_frame_seconds = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    bvh.ComputeGlobalTransforms(frame, transforms);
+                    for (const auto& transform : transforms)
+                    {
+                        checksum_per_frame += transform.translation().sum();
+                    }
+                }
+            });
+
+        // Evaluate the whole clip at once
+        double       checksum_clip = 0.0;
+        const double clip_seconds  = benchutil::measure_seconds(
+            [&]() { checksum_clip += bvh.ComputeGlobalPositions(0, bvh.frames()).sum(); });
+
+        std::cout << file_path << " (" << num_joints << " joints, " << bvh.frames() << " frames)" << std::endl;
+        print_throughput("ComputeGlobalTransforms per frame", per_frame_seconds, num_evaluations);
+        print_throughput("ComputeGlobalPositions per clip  ", clip_seconds, num_evaluations);
+        std::cout << "  speed-up: x" << per_frame_seconds / clip_seconds << " (checksums: " << checksum_per_frame
+                  << ", " << checksum_clip << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/compressed-motion.hpp>
+#include <bvh11/pose.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+int main(int argc, char* argv[])
+{
+    // Maximum position error in the units of the original files; the scaled files use the same bound scaled by 0.01
+    const double max_position_error = (argc >= 2) ? std::atof(argv[1]) : 0.1;
+
+    const std::vector<std::pair<std::string, double>> files = {
+        {"131_01.bvh", 1.0},
+        {"131_02.bvh", 1.0},
+        {"131_03.bvh", 1.0},
+        {"scaled_131_01.bvh", 0.01},
+        {"scaled_131_02.bvh", 0.01},
+        {"scaled_131_03.bvh", 0.01},
+    };
+
+    for (const auto& file : files)
+    {
+        const bvh11::BvhObject bvh(file.first);
+
+        std::mt19937                       random_engine(0);
+        std::uniform_int_distribution<int> distribution(0, bvh.frames() - 1);
+
+        std::vector<int> frames(10000);
+        for (int& frame : frames)
+        {
+            frame = distribution(random_engine);
+        }
+
+        std::cout << file.first << " (" << bvh.frames() << " frames, max error " << max_position_error * file.second
+                  << ")" << std::endl;
+
+        for (const bool use_quaternions : {false, true})
+        {
+            bvh11::CompressionOptions options;
+            options.max_position_error = max_position_error * file.second;
+            options.use_quaternions    = use_quaternions;
+
+            const double compress_seconds =
+                benchutil::measure_seconds([&]() { bvh11::CompressedMotion compressed(bvh, options); }, 1);
+
+            const bvh11::CompressedMotion compressed(bvh, options);
+
+            // Random-access decompression of single frames
+            Eigen::VectorXd values;
+            double          checksum      = 0.0;
+            const double    frame_seconds = benchutil::measure_seconds(
+                [&]()
+                {
+                    for (const int frame : frames)
+                    {
+                        compressed.DecompressFrame(frame, values);
+                        checksum += values(0);
+                    }
+                });
+
+            bvh11::Pose  pose;
+            const double pose_seconds = benchutil::measure_seconds(
+                [&]()
+                {
+                    for (const int frame : frames)
+                    {
+                        compressed.DecompressPose(frame, pose, values);
+                        checksum += pose.translations[0](0);
+                    }
+                });
+
+            std::cout << "  " << (use_quaternions ? "quaternion" : "euler     ") << ": ratio x"
+                      << static_cast<double>(compressed.uncompressed_size_bytes()) / compressed.compressed_size_bytes()
+                      << ", measured error " << compressed.max_measured_error() << ", raw channels "
+                      << compressed.num_raw_channels() << ", compress "
+                      << 1000.0 * compress_seconds << " ms, DecompressFrame "
+                      << 1e9 * frame_seconds / frames.size() << " ns, DecompressPose "
+                      << 1e9 * pose_seconds / frames.size() << " ns (checksum: " << checksum << ")" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /// \brief Measure the per-frame and the batched forward kinematics of all the frames.
+    void measure_kinematics(const bvh11::BvhObject& bvh, double& frame_seconds, double& batch_seconds)
+    {
+        bvh11::TransformList transforms;
+        frame_seconds = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    bvh.ComputeGlobalTransforms(frame, transforms);
+                }
+            },
+            5);
+        batch_seconds = benchutil::measure_seconds([&]() { bvh.ComputeGlobalPositions(0, bvh.frames()); }, 5);
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const double tolerance = (argc >= 2) ? std::atof(argv[1]) : 0.0;
+
+    const std::vector<std::string> file_paths = {"131_01.bvh",
+                                                 "131_02.bvh",
+                                                 "131_03.bvh",
+                                                 "scaled_131_01.bvh",
+                                                 "scaled_131_02.bvh",
+                                                 "scaled_131_03.bvh"};
+
+    std::cout << "Tolerance: " << tolerance << std::endl;
+
+    for (const std::string& file_path : file_paths)
+    {
+        bvh11::BvhObject bvh(file_path);
+
+        double dense_frame_seconds = 0.0;
+        double dense_batch_seconds = 0.0;
+        measure_kinematics(bvh, dense_frame_seconds, dense_batch_seconds);
+
+        const double analysis_seconds =
+            benchutil::measure_seconds([&]() { bvh.AnalyzeConstantChannels(tolerance); }, 5);
+
+        double frame_seconds = 0.0;
+        double batch_seconds = 0.0;
+        measure_kinematics(bvh, frame_seconds, batch_seconds);
+
+        int num_constant_channels = 0;
+        int num_static_joints     = 0;
+        for (const std::uint8_t is_constant : bvh.constant_channel_flags())
+        {
+            num_constant_channels += is_constant;
+        }
+        for (const std::uint8_t is_static : bvh.static_joint_flags())
+        {
+            num_static_joints += is_static;
+        }
+
+        const std::size_t motion_bytes = sizeof(double) * bvh.motion().size();
+
+        std::cout << file_path << " (" << bvh.frames() << " frames)" << std::endl;
+        std::cout << "  constant channels: " << num_constant_channels << " / " << bvh.channels().size()
+                  << ", static joints: " << num_static_joints << " / " << bvh.GetJointList().size() << std::endl;
+        std::cout << "  redundant motion (estimate, not reclaimed): " << bvh.EstimateRedundantMotionBytes() / 1024.0
+                  << " KB of " << motion_bytes / 1024.0 << " KB" << std::endl;
+        std::cout << "  analysis: " << 1e3 * analysis_seconds << " ms" << std::endl;
+        std::cout << "  ComputeGlobalTransforms: x" << dense_frame_seconds / frame_seconds << " ("
+                  << bvh.frames() / frame_seconds << " frames/s)" << std::endl;
+        std::cout << "  ComputeGlobalPositions: x" << dense_batch_seconds / batch_seconds << " ("
+                  << bvh.frames() / batch_seconds << " frames/s)" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/motion-editor.hpp>
+#include <bvh11/skeleton.hpp>
+#include <iostream>
+
+int main()
+{
+    // Joints from the root to a hand and a leaf of the spine, so that the edited subtrees have various sizes
+    const std::vector<std::string> joint_names = {"Hips", "lowerback", "Chest2", "LeftShoulder", "LeftWrist", "Head"};
+
+    bvh11::BvhObject bvh("131_01.bvh");
+
+    const auto joints = bvh.GetJointList();
+
+    std::cout << "131_01.bvh (" << joints.size() << " joints, " << bvh.frames() << " frames)" << std::endl;
+
+    for (const std::string& joint_name : joint_names)
+    {
+        const int joint_index   = bvh.skeleton()->FindJoint(joint_name);
+        const int channel_index = bvh.skeleton()->channel_starts()[joint_index] +
+                                  bvh.skeleton()->channel_counts()[joint_index] - 1;
+
+        bvh11::MotionEditor editor(bvh);
+
+        // Evaluate all the frames once so that the cache is warm
+        for (int frame = 0; frame < bvh.frames(); ++frame)
+        {
+            editor.GetTransformations(frame);
+        }
+
+        // Edit a single channel at every frame, and query all the joints of the frame
+        const std::size_t evaluated_before = editor.num_evaluated_joints();
+        const double      editor_seconds   = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    editor.SetChannelValue(frame, channel_index, editor.GetChannelValue(frame, channel_index) + 1e-3);
+                    editor.GetTransformations(frame);
+                }
+            },
+            1);
+        const double evaluated_per_edit =
+            static_cast<double>(editor.num_evaluated_joints() - evaluated_before) / bvh.frames();
+
+        // Reference: the same edits followed by a query of every joint with GetTransformation
+        const double direct_seconds = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    bvh.mutable_motion()(frame, channel_index) += 1e-3;
+                    for (const auto& joint : joints)
+                    {
+                        bvh.GetTransformation(joint, frame);
+                    }
+                }
+            },
+            1);
+
+        std::cout << "  " << joint_name << ": " << evaluated_per_edit << " joints recomputed per edit, "
+                  << 1e9 * editor_seconds / bvh.frames() << " ns per edit+query (GetTransformation: "
+                  << 1e9 * direct_seconds / bvh.frames() << " ns, x" << direct_seconds / editor_seconds << ")"
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/skeleton.hpp>
+#include <iostream>
+
+int main()
+{
+    const std::vector<std::string> file_paths = {
+        "131_01.bvh",
+        "131_02.bvh",
+        "131_03.bvh",
+    };
+
+    for (const std::string& file_path : file_paths)
+    {
+        const bvh11::BvhObject bvh(file_path);
+
+        const auto joints = bvh.GetJointList();
+
+        // Evaluate every joint by walking up to the root
+        double       checksum_per_joint = 0.0;
+        const double per_joint_seconds  = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    for (const auto& joint : joints)
+                    {
+                        checksum_per_joint += bvh.GetTransformation(joint, frame).translation().sum();
+                    }
+                }
+            });
+
+        // Evaluate all the joints in a single sweep
+        double               checksum_batch = 0.0;
+        bvh11::TransformList transforms;
+        const double         batch_seconds = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    bvh.ComputeGlobalTransforms(frame, transforms);
+                    for (const auto& transform : transforms)
+                    {
+                        checksum_batch += transform.translation().sum();
+                    }
+                }
+            });
+
+        // Evaluate the local transformation of every joint with the per-channel runtime dispatch
+        double       checksum_local_generic = 0.0;
+        const double local_generic_seconds  = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    for (const auto& joint : joints)
+                    {
+                        checksum_local_generic += bvh.GetTransformationRelativeToParent(joint, frame).linear().sum();
+                    }
+                }
+            });
+
+        // Evaluate the local transformation of every joint with the kernels specialized for rotation orders
+        const bvh11::Skeleton& skeleton              = *bvh.skeleton();
+        double                 checksum_local_kernel = 0.0;
+        const double           local_kernel_seconds  = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    const double* values = bvh.motion().data() + frame;
+                    for (int joint_index = 0; joint_index < skeleton.num_joints(); ++joint_index)
+                    {
+                        checksum_local_kernel +=
+                            skeleton.ComputeLocalTransform(joint_index, values, bvh.frames()).linear().sum();
+                    }
+                }
+            });
+
+        const double num_evaluations = static_cast<double>(bvh.frames()) * static_cast<double>(joints.size());
+
+        std::cout << file_path << " (" << joints.size() << " joints, " << bvh.frames() << " frames)" << std::endl;
+        std::cout << "  GetTransformation per joint : " << 1e9 * per_joint_seconds / num_evaluations << " ns/joint"
+                  << std::endl;
+        std::cout << "  ComputeGlobalTransforms     : " << 1e9 * batch_seconds / num_evaluations << " ns/joint"
+                  << std::endl;
+        std::cout << "  speed-up: x" << per_joint_seconds / batch_seconds << " (checksums: " << checksum_per_joint
+                  << ", " << checksum_batch << ")" << std::endl;
+        std::cout << "  GetTransformationRelativeToParent : " << 1e9 * local_generic_seconds / num_evaluations
+                  << " ns/joint" << std::endl;
+        std::cout << "  Skeleton::ComputeLocalTransform   : " << 1e9 * local_kernel_seconds / num_evaluations
+                  << " ns/joint" << std::endl;
+        std::cout << "  speed-up: x" << local_generic_seconds / local_kernel_seconds << " (checksums: "
+                  << checksum_local_generic << ", " << checksum_local_kernel << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/allocation-counting.hpp>
+#include <bvh11/statistics.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    const int num_objects = (argc >= 2) ? std::atoi(argv[1]) : 200;
+    const int num_joints  = (argc >= 3) ? std::atoi(argv[2]) : 301;
+
+    // Many joints and few frames, so that the hierarchy dominates the load
+    const std::string file_path = "synthetic_hierarchy_arena_benchmark.bvh";
+    benchutil::create_synthetic_bvh_file(file_path, num_joints, 30, 10);
+
+    std::cout << "#Objects: " << num_objects << ", #Joints: " << num_joints << std::endl;
+
+    using Clock = std::chrono::steady_clock;
+
+    for (const bvh11::HierarchyStorage storage : {bvh11::HierarchyStorage::heap, bvh11::HierarchyStorage::arena})
+    {
+        bvh11::LoadStatistics statistics;
+        bvh11::LoadOptions    options;
+        options.hierarchy_storage = storage;
+        options.statistics        = &statistics;
+
+        // Measure the loads and the destruction of the objects separately, taking the best of the repeats
+        double load_seconds     = std::numeric_limits<double>::max();
+        double teardown_seconds = std::numeric_limits<double>::max();
+        for (int repeat = 0; repeat < 5; ++repeat)
+        {
+            std::vector<std::unique_ptr<bvh11::BvhObject>> objects;
+            objects.reserve(num_objects);
+
+            const auto load_begin = Clock::now();
+            for (int i = 0; i < num_objects; ++i)
+            {
+                objects.emplace_back(new bvh11::BvhObject(file_path, options));
+            }
+            const auto load_end = Clock::now();
+            objects.clear();
+            const auto teardown_end = Clock::now();
+
+            load_seconds     = std::min(load_seconds, std::chrono::duration<double>(load_end - load_begin).count());
+            teardown_seconds = std::min(teardown_seconds,
+                                        std::chrono::duration<double>(teardown_end - load_end).count());
+        }
+
+        const std::string label = (storage == bvh11::HierarchyStorage::heap) ? "heap" : "arena";
+        std::cout << label << std::endl;
+        std::cout << "  load: " << 1e3 * load_seconds / num_objects << " ms/object" << std::endl;
+        std::cout << "  teardown: " << 1e3 * teardown_seconds / num_objects << " ms/object" << std::endl;
+
+        // The breakdown is available only if the library is built with BVH11_ENABLE_STATISTICS
+        if (bvh11::is_statistics_enabled())
+        {
+            std::cout << "  hierarchy: " << 1e3 * statistics.hierarchy_seconds / statistics.num_files << " ms/object"
+                      << std::endl;
+            std::cout << "  allocations: " << statistics.num_allocations / statistics.num_files << " /object"
+                      << std::endl;
+        }
+    }
+
+    std::remove(file_path.c_str());
+
+    return 0;
+}
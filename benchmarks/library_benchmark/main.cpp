@@ -0,0 +1,67 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/library.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+    const int num_files       = (argc >= 2) ? std::atoi(argv[1]) : 200;
+    const int num_frames      = (argc >= 3) ? std::atoi(argv[2]) : 1000;
+    const int max_num_threads = (argc >= 4) ? std::atoi(argv[3]) : std::thread::hardware_concurrency();
+
+    // Create many takes of the same skeleton with different motions (31 joints correspond to 96 channels)
+    std::vector<std::string> file_paths;
+    std::size_t              total_size = 0;
+    for (int i = 0; i < num_files; ++i)
+    {
+        file_paths.push_back("synthetic_library_benchmark_" + std::to_string(i) + ".bvh");
+        benchutil::create_synthetic_bvh_file(file_paths.back(), 31, 10, num_frames, i);
+        total_size += benchutil::get_file_size(file_paths.back());
+    }
+
+    std::cout << "#Files: " << num_files << ", #Frames per file: " << num_frames << std::endl;
+
+    auto print_files_per_second = [&](const double seconds) -> void
+    { std::cout << "  " << num_files / seconds << " files/s" << std::endl; };
+
+    // Baseline: one object per file, loaded serially
+    const double serial_seconds = benchutil::measure_seconds(
+        [&]()
+        {
+            std::vector<std::shared_ptr<bvh11::BvhObject>> clips;
+            for (const std::string& file_path : file_paths)
+            {
+                clips.push_back(std::make_shared<bvh11::BvhObject>(file_path));
+            }
+        },
+        3);
+    benchutil::print_result("BvhObject (serial)", serial_seconds, total_size);
+    print_files_per_second(serial_seconds);
+
+    for (int num_threads = 1; num_threads <= std::max(1, max_num_threads); ++num_threads)
+    {
+        int num_hierarchies = 0;
+
+        const double seconds = benchutil::measure_seconds(
+            [&]()
+            {
+                const bvh11::BvhLibrary library(file_paths, bvh11::LoadOptions(), num_threads);
+                num_hierarchies = library.num_hierarchies();
+            },
+            3);
+        benchutil::print_result("BvhLibrary (" + std::to_string(num_threads) + " thread(s))", seconds, total_size);
+        print_files_per_second(seconds);
+        std::cout << "  speed-up: x" << serial_seconds / seconds << ", #hierarchies: " << num_hierarchies
+                  << std::endl;
+    }
+
+    for (const std::string& file_path : file_paths)
+    {
+        std::remove(file_path.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#ifndef BVH11_BASELINE_PARSER_HPP_
+#define BVH11_BASELINE_PARSER_HPP_
+
+#include <Eigen/Core>
+#include <cassert>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace baseline
+{
+    /// \brief Split a line in the same way as the original parser (i.e., by a regular expression).
+    inline std::vector<std::string> split(const std::string& sequence, const std::string& pattern)
+    {
+        const std::regex                 regex(pattern);
+        const std::sregex_token_iterator first{sequence.begin(), sequence.end(), regex, -1};
+        const std::sregex_token_iterator last{};
+        return std::vector<std::string>{first->str().empty() ? std::next(first) : first, last};
+    }
+
+    inline std::vector<std::string> tokenize_next_line(std::ifstream& ifs)
+    {
+        std::string line;
+        const bool  is_succeeded = static_cast<bool>(std::getline(ifs, line));
+        assert(is_succeeded && "Failed to read the next line");
+        static_cast<void>(is_succeeded);
+        return split(line, R"([\t\s]+)");
+    }
+
+    /// \brief Load the motion of a BVH file with the std::getline and std::regex based tokenization and the
+    ///        std::stod conversion of the original parser.
+    /// \details The joints are not instantiated, since their cost is negligible compared with the tokenization;
+    ///          every line is still split and every number is still converted as before.
+    inline Eigen::MatrixXd load_motion(const std::string& file_path)
+    {
+        std::ifstream ifs(file_path);
+        assert(ifs.is_open() && "Failed to open the input file.");
+
+        // Read the HIERARCHY part, where only the number of the channels is kept
+        int         num_channels = 0;
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            const std::vector<std::string> tokens = split(line, R"([\t\s]+)");
+            if (tokens.empty())
+            {
+                continue;
+            }
+            else if (tokens[0] == "OFFSET")
+            {
+                for (int i = 1; i < 4; ++i)
+                {
+                    static_cast<void>(std::stod(tokens[i]));
+                }
+            }
+            else if (tokens[0] == "CHANNELS")
+            {
+                num_channels += std::stoi(tokens[1]);
+            }
+            else if (tokens[0] == "MOTION")
+            {
+                break;
+            }
+        }
+
+        // Read the MOTION part
+        const std::vector<std::string> tokens_frames     = tokenize_next_line(ifs);
+        const std::vector<std::string> tokens_frame_time = tokenize_next_line(ifs);
+        const int                      frames            = std::stoi(tokens_frames[1]);
+        static_cast<void>(std::stod(tokens_frame_time[2]));
+
+        Eigen::MatrixXd motion(frames, num_channels);
+        for (int frame_index = 0; frame_index < frames; ++frame_index)
+        {
+            const std::vector<std::string> tokens = tokenize_next_line(ifs);
+            assert(static_cast<int>(tokens.size()) == num_channels && "Found invalid motion data");
+
+            for (int channel_index = 0; channel_index < num_channels; ++channel_index)
+            {
+                motion(frame_index, channel_index) = std::stod(tokens[channel_index]);
+            }
+        }
+
+        return motion;
+    }
+} // namespace baseline
+
+#endif
@@ -0,0 +1,70 @@
+#include "baseline-parser.hpp"
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    const int num_synthetic_frames = (argc >= 2) ? std::atoi(argv[1]) : 100000;
+
+    const std::vector<std::string> file_paths = {
+        "131_01.bvh",
+        "131_02.bvh",
+        "131_03.bvh",
+        "scaled_131_01.bvh",
+        "scaled_131_02.bvh",
+        "scaled_131_03.bvh",
+    };
+
+    bvh11::LoadOptions stream_options;
+    stream_options.use_memory_mapping = false;
+
+    bvh11::LoadOptions mapping_options;
+    mapping_options.use_memory_mapping = true;
+
+    // Measure the loading time of the bundled files, including the original std::getline and std::regex parser
+    for (const std::string& file_path : file_paths)
+    {
+        const double baseline_seconds =
+            benchutil::measure_seconds([&]() { baseline::load_motion(file_path); }, 3);
+        const double stream_seconds =
+            benchutil::measure_seconds([&]() { bvh11::BvhObject bvh(file_path, stream_options); });
+        const double mapping_seconds =
+            benchutil::measure_seconds([&]() { bvh11::BvhObject bvh(file_path, mapping_options); });
+
+        const bool is_identical = baseline::load_motion(file_path) == bvh11::BvhObject(file_path).motion();
+
+        benchutil::print_result(file_path + " [baseline]", baseline_seconds, benchutil::get_file_size(file_path));
+        benchutil::print_result(file_path + " [stream]", stream_seconds, benchutil::get_file_size(file_path));
+        benchutil::print_result(file_path + " [mmap]", mapping_seconds, benchutil::get_file_size(file_path));
+        std::cout << "  speed-up over baseline: x" << baseline_seconds / stream_seconds << " (stream), x"
+                  << baseline_seconds / mapping_seconds << " (mmap); identical values: "
+                  << (is_identical ? "yes" : "no") << std::endl;
+    }
+
+    // Measure the loading time of a large synthetic file
+    const std::string synthetic_file_path = "synthetic_load_benchmark.bvh";
+    benchutil::create_tiled_bvh_file("131_01.bvh", synthetic_file_path, num_synthetic_frames);
+
+    const std::string synthetic_label = synthetic_file_path + " (" + std::to_string(num_synthetic_frames) + " frames)";
+    const std::size_t synthetic_size  = benchutil::get_file_size(synthetic_file_path);
+
+    const double baseline_seconds =
+        benchutil::measure_seconds([&]() { baseline::load_motion(synthetic_file_path); }, 1);
+    const double stream_seconds =
+        benchutil::measure_seconds([&]() { bvh11::BvhObject bvh(synthetic_file_path, stream_options); }, 3);
+    const double mapping_seconds =
+        benchutil::measure_seconds([&]() { bvh11::BvhObject bvh(synthetic_file_path, mapping_options); }, 3);
+
+    benchutil::print_result(synthetic_label + " [baseline]", baseline_seconds, synthetic_size);
+    benchutil::print_result(synthetic_label + " [stream]", stream_seconds, synthetic_size);
+    benchutil::print_result(synthetic_label + " [mmap]", mapping_seconds, synthetic_size);
+    std::cout << "  speed-up over baseline: x" << baseline_seconds / stream_seconds << " (stream), x"
+              << baseline_seconds / mapping_seconds << " (mmap)" << std::endl;
+
+    std::remove(synthetic_file_path.c_str());
+
+    return 0;
+}
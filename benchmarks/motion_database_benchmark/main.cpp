@@ -0,0 +1,96 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/motion-database.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+    const int num_clips       = (argc >= 2) ? std::atoi(argv[1]) : 100;
+    const int max_num_threads = (argc >= 3) ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+    const int num_queries     = 20;
+
+    // Use the same take repeatedly as a database of many clips
+    const auto clip = std::make_shared<const bvh11::BvhObject>("131_01.bvh");
+
+    const std::vector<std::shared_ptr<const bvh11::BvhObject>> clips(num_clips, clip);
+
+    bvh11::MotionDatabase database(clips);
+    std::cout << "#Clips: " << num_clips << ", #Frames: " << database.num_frames() << std::endl;
+
+    // Typical motion matching features: the feet, the hands, and the head with their velocities
+    bvh11::FeatureOptions options;
+    for (const char* joint_name : {"LeftAnkle", "RightAnkle", "LeftWrist", "RightWrist", "Head"})
+    {
+        options.joint_indices.push_back(clip->skeleton()->FindJoint(joint_name));
+    }
+
+    const double feature_seconds = benchutil::measure_seconds([&]() { database.ComputeFeatures(options); }, 3);
+    std::cout << "Features: " << 1000.0 * feature_seconds << " ms (#features: " << database.num_features() << ")"
+              << std::endl;
+
+    // Queries taken from the database with a small perturbation
+    std::vector<Eigen::VectorXd> queries;
+    for (int i = 0; i < num_queries; ++i)
+    {
+        const int frame = static_cast<int>((static_cast<long long>(i) * 7919) % database.num_frames());
+        queries.push_back(database.features().row(frame).transpose().array() + 1e-3);
+    }
+
+    // Baseline: frame-major (array of structures) features scanned frame by frame
+    using RowMajorMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    const RowMajorMatrixXd frame_major_features = database.features();
+
+    int          baseline_frame   = -1;
+    const double baseline_seconds = benchutil::measure_seconds(
+        [&]()
+        {
+            for (const Eigen::VectorXd& query : queries)
+            {
+                double best = std::numeric_limits<double>::max();
+                for (int frame = 0; frame < database.num_frames(); ++frame)
+                {
+                    double squared_distance = 0.0;
+                    for (int feature_index = 0; feature_index < database.num_features(); ++feature_index)
+                    {
+                        const double difference = frame_major_features(frame, feature_index) - query(feature_index);
+                        squared_distance += difference * difference;
+                    }
+                    if (squared_distance < best)
+                    {
+                        best           = squared_distance;
+                        baseline_frame = frame;
+                    }
+                }
+            }
+        });
+
+    const std::size_t bytes_per_search = sizeof(double) * database.features().size();
+
+    benchutil::print_result("Frame-major scan", baseline_seconds / num_queries, bytes_per_search);
+
+    for (int num_threads = 1; num_threads <= std::max(1, max_num_threads); ++num_threads)
+    {
+        int          frame   = -1;
+        const double seconds = benchutil::measure_seconds(
+            [&]()
+            {
+                for (const Eigen::VectorXd& query : queries)
+                {
+                    frame = database.FindNearestFrame(query, Eigen::VectorXd(), num_threads).frame;
+                }
+            });
+
+        benchutil::print_result("MotionDatabase (" + std::to_string(num_threads) + " thread(s))",
+                                seconds / num_queries,
+                                bytes_per_search);
+        std::cout << "  speed-up: x" << baseline_seconds / seconds << ", same result: " << (frame == baseline_frame)
+                  << std::endl;
+    }
+
+    return 0;
+}
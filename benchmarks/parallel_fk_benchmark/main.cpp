@@ -0,0 +1,79 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <algorithm>
+#include <bvh11/clip-evaluator.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+    const int num_frames      = (argc >= 2) ? std::atoi(argv[1]) : 20000;
+    const int num_joints      = (argc >= 3) ? std::atoi(argv[2]) : 101;
+    const int max_num_threads = (argc >= 4) ? std::atoi(argv[3]) : std::thread::hardware_concurrency();
+    const int window_size     = (argc >= 5) ? std::atoi(argv[4]) : 256;
+
+    // Create a long synthetic clip
+    const std::string file_path = "synthetic_parallel_fk_benchmark.bvh";
+    benchutil::create_synthetic_bvh_file(file_path, num_joints, 10, num_frames);
+
+    bvh11::LoadOptions load_options;
+    load_options.num_threads = 0;
+
+    const bvh11::BvhObject bvh(file_path, load_options);
+    std::remove(file_path.c_str());
+
+    const double num_evaluations = static_cast<double>(bvh.frames()) * bvh.GetJointList().size();
+
+    std::cout << "#Frames: " << bvh.frames() << ", #Joints: " << bvh.GetJointList().size() << std::endl;
+
+    // Preallocate the output so that only the evaluation is measured
+    bvh11::TransformList transforms(static_cast<std::size_t>(bvh.frames()) * bvh.GetJointList().size());
+
+    const std::vector<std::pair<std::string, bvh11::ExecutionPolicy>> policies = {
+        {"thread pool", bvh11::ExecutionPolicy::thread_pool},
+        {"openmp", bvh11::ExecutionPolicy::openmp},
+    };
+
+    bvh11::ClipEvaluationOptions sequential_options;
+    sequential_options.policy = bvh11::ExecutionPolicy::sequential;
+
+    const bvh11::ClipEvaluator sequential_evaluator(bvh, sequential_options);
+    const double               sequential_seconds =
+        benchutil::measure_seconds([&]() { sequential_evaluator.Evaluate(transforms); }, 3);
+
+    std::cout << "sequential: " << 1e-6 * num_evaluations / sequential_seconds << " M frames*joints/s" << std::endl;
+
+    for (const auto& policy : policies)
+    {
+        for (int num_threads = 1; num_threads <= std::max(1, max_num_threads); ++num_threads)
+        {
+            bvh11::ClipEvaluationOptions options;
+            options.policy      = policy.second;
+            options.num_threads = num_threads;
+
+            const bvh11::ClipEvaluator evaluator(bvh, options);
+            const double seconds = benchutil::measure_seconds([&]() { evaluator.Evaluate(transforms); }, 3);
+
+            // Evaluate short windows one after another, as in a playback that evaluates a few frames at a time
+            const double window_seconds = benchutil::measure_seconds(
+                [&]()
+                {
+                    for (int frame = 0; frame < bvh.frames(); frame += window_size)
+                    {
+                        const int frame_end = std::min(frame + window_size, bvh.frames());
+                        evaluator.Evaluate(frame, frame_end, transforms.data() + frame * bvh.GetJointList().size());
+                    }
+                },
+                3);
+
+            std::cout << policy.first << ", " << num_threads << " thread(s): " << 1e-6 * num_evaluations / seconds
+                      << " M frames*joints/s (speed-up: x" << sequential_seconds / seconds << "), windows of "
+                      << window_size << " frames: " << 1e-6 * num_evaluations / window_seconds << " M frames*joints/s"
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
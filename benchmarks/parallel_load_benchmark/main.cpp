@@ -0,0 +1,42 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+    const int num_frames      = (argc >= 2) ? std::atoi(argv[1]) : 100000;
+    const int num_joints      = (argc >= 3) ? std::atoi(argv[2]) : 101;
+    const int max_num_threads = (argc >= 4) ? std::atoi(argv[3]) : std::thread::hardware_concurrency();
+
+    // Create a long synthetic file (101 joints correspond to 306 channels)
+    const std::string file_path = "synthetic_parallel_load_benchmark.bvh";
+    benchutil::create_synthetic_bvh_file(file_path, num_joints, 10, num_frames);
+
+    const std::size_t file_size = benchutil::get_file_size(file_path);
+
+    std::cout << "#Frames: " << num_frames << ", #Joints: " << num_joints << std::endl;
+
+    double sequential_seconds = 0.0;
+    for (int num_threads = 1; num_threads <= std::max(1, max_num_threads); ++num_threads)
+    {
+        bvh11::LoadOptions options;
+        options.use_memory_mapping = true;
+        options.num_threads        = num_threads;
+
+        const double seconds = benchutil::measure_seconds([&]() { bvh11::BvhObject bvh(file_path, options); }, 3);
+        if (num_threads == 1)
+        {
+            sequential_seconds = seconds;
+        }
+
+        benchutil::print_result(std::to_string(num_threads) + " thread(s)", seconds, file_size);
+        std::cout << "  speed-up: x" << sequential_seconds / seconds << std::endl;
+    }
+
+    std::remove(file_path.c_str());
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/playback-motion.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    /// \brief Measure the footprint, the forward kinematics throughput, and the position error of a storage type.
+    template <typename StorageScalar>
+    void run(const std::string& label, const bvh11::BvhObject& bvh, const Eigen::MatrixXd& reference_positions)
+    {
+        using PlaybackMotion = bvh11::PlaybackMotion<StorageScalar>;
+
+        const PlaybackMotion motion(bvh);
+        const int            num_frames = motion.frames();
+
+        typename PlaybackMotion::PositionMatrix positions;
+        const double batch_seconds = benchutil::measure_seconds(
+            [&]() { motion.ComputeGlobalPositions(0, num_frames, positions); }, 5);
+
+        typename PlaybackMotion::TransformList transforms;
+        const double frame_seconds = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < num_frames; ++frame)
+                {
+                    motion.ComputeGlobalTransforms(frame, transforms);
+                }
+            },
+            5);
+
+        const double max_error = (positions.template cast<double>() - reference_positions).cwiseAbs().maxCoeff();
+
+        std::cout << label << std::endl;
+        std::cout << "  motion: " << motion.size_bytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+        std::cout << "  ComputeGlobalPositions: " << num_frames / batch_seconds << " frames/s" << std::endl;
+        std::cout << "  ComputeGlobalTransforms: " << num_frames / frame_seconds << " frames/s" << std::endl;
+        std::cout << "  max position error: " << max_error << std::endl;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const double num_minutes = (argc >= 2) ? std::atof(argv[1]) : 10.0;
+
+    // Make a long capture by repeating the frames of a take
+    bvh11::BvhObject bvh("131_01.bvh");
+
+    const int num_original_frames = bvh.frames();
+    const int num_frames          = static_cast<int>(num_minutes * 60.0 / bvh.frame_time());
+
+    bvh.ResizeFrames(num_frames);
+    Eigen::MatrixXd& motion = bvh.mutable_motion();
+    for (int frame = num_original_frames; frame < num_frames; ++frame)
+    {
+        motion.row(frame) = motion.row(frame % num_original_frames);
+    }
+
+    std::cout << "#Frames: " << num_frames << ", #Joints: " << bvh.GetJointList().size() << std::endl;
+
+    const Eigen::MatrixXd reference_positions = bvh.ComputeGlobalPositions(0, num_frames);
+
+    run<double>("double", bvh, reference_positions);
+    run<float>("float", bvh, reference_positions);
+    run<Eigen::half>("half (float computation)", bvh, reference_positions);
+
+    return 0;
+}
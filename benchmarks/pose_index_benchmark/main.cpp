@@ -0,0 +1,127 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/pose-index.hpp>
+#include <bvh11/skeleton.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+int main(int argc, char* argv[])
+{
+    const int num_copies  = (argc >= 2) ? std::atoi(argv[1]) : 100;
+    const int num_queries = (argc >= 3) ? std::atoi(argv[2]) : 200;
+
+    // Make many distinct takes by perturbing the channels of the original takes with slow random drifts
+    std::mt19937                                         engine(0);
+    std::vector<std::shared_ptr<const bvh11::BvhObject>> clips;
+    for (const char* file_path : {"131_01.bvh", "131_02.bvh", "131_03.bvh"})
+    {
+        const bvh11::BvhObject original(file_path);
+        for (int copy = 0; copy < num_copies; ++copy)
+        {
+            std::uniform_real_distribution<> distribution(-3.0, 3.0);
+
+            auto             clip   = std::make_shared<bvh11::BvhObject>(original);
+            Eigen::MatrixXd& motion = clip->mutable_motion();
+            for (int channel = 0; channel < motion.cols(); ++channel)
+            {
+                const double amplitude = distribution(engine);
+                const double frequency = 0.01 * distribution(engine);
+                for (int frame = 0; frame < motion.rows(); ++frame)
+                {
+                    motion(frame, channel) += amplitude * std::sin(frequency * frame);
+                }
+            }
+            clips.push_back(clip);
+        }
+    }
+
+    bvh11::MotionDatabase database(clips);
+
+    bvh11::FeatureOptions feature_options;
+    for (const char* joint_name : {"LeftAnkle", "RightAnkle", "LeftWrist", "RightWrist", "Head"})
+    {
+        feature_options.joint_indices.push_back(database.skeleton()->FindJoint(joint_name));
+    }
+    database.ComputeFeatures(feature_options);
+
+    std::cout << "#Frames: " << database.num_frames() << ", #Features: " << database.num_features() << std::endl;
+
+    // Build the index clip by clip
+    bvh11::PoseIndex index(database.num_features());
+
+    const auto build_begin = std::chrono::steady_clock::now();
+    for (int clip_index = 0; clip_index < database.num_clips(); ++clip_index)
+    {
+        const int frame_begin = database.clip_frame_begin(clip_index);
+        const int frame_end   = database.clip_frame_end(clip_index);
+        index.AddFrames(database.features().middleRows(frame_begin, frame_end - frame_begin), frame_begin);
+    }
+    const auto build_end = std::chrono::steady_clock::now();
+
+    std::cout << "Build (incremental): " << 1000.0 * std::chrono::duration<double>(build_end - build_begin).count()
+              << " ms, #trees: " << index.num_trees() << std::endl;
+
+    // Write and load the index
+    const std::string index_path = "pose_index_benchmark.idx";
+    index.WriteFile(index_path);
+    const double load_seconds = benchutil::measure_seconds([&]() { bvh11::PoseIndex loaded(index_path); }, 3);
+    benchutil::print_result("Load", load_seconds, benchutil::get_file_size(index_path));
+    std::remove(index_path.c_str());
+
+    // Queries near the frames of the database
+    std::normal_distribution<> noise(0.0, 1.0);
+    Eigen::MatrixXd            queries(num_queries, database.num_features());
+    for (int i = 0; i < num_queries; ++i)
+    {
+        const int frame = std::uniform_int_distribution<>(0, database.num_frames() - 1)(engine);
+        for (int feature_index = 0; feature_index < database.num_features(); ++feature_index)
+        {
+            queries(i, feature_index) = database.features()(frame, feature_index) + noise(engine);
+        }
+    }
+
+    // Exact answers by brute force
+    std::vector<bvh11::NearestFrame> exact_results(num_queries);
+    const double                     exact_seconds = benchutil::measure_seconds(
+        [&]()
+        {
+            for (int i = 0; i < num_queries; ++i)
+            {
+                exact_results[i] = database.FindNearestFrame(queries.row(i).transpose(), Eigen::VectorXd(), 1);
+            }
+        },
+        1);
+    std::cout << "Brute force: " << 1000.0 * exact_seconds / num_queries << " ms/query" << std::endl;
+
+    for (const int max_leaf_visits : {1, 2, 4, 8, 16, 32, 64, 256, 0})
+    {
+        bvh11::PoseSearchOptions options;
+        options.max_leaf_visits = max_leaf_visits;
+        options.num_threads     = 1;
+
+        std::vector<bvh11::NearestFrame> results;
+        auto search = [&]() -> void { index.FindNearestFrames(queries, results, options); };
+
+        const double seconds = benchutil::measure_seconds(search);
+
+        int    num_hits       = 0;
+        double distance_ratio = 0.0;
+        for (int i = 0; i < num_queries; ++i)
+        {
+            num_hits += (results[i].squared_distance <= exact_results[i].squared_distance * (1.0 + 1e-9));
+            distance_ratio += std::sqrt(results[i].squared_distance / exact_results[i].squared_distance);
+        }
+
+        const std::string label = max_leaf_visits == 0 ? "exact" : std::to_string(max_leaf_visits) + " leaves";
+        std::cout << "PoseIndex (" << label << "): " << 1000.0 * seconds / num_queries
+                  << " ms/query, recall: " << static_cast<double>(num_hits) / num_queries
+                  << ", distance ratio: " << distance_ratio / num_queries
+                  << ", speed-up: x" << exact_seconds / seconds << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/pose.hpp>
+#include <iostream>
+#include <random>
+
+int main()
+{
+    const std::vector<std::string> file_paths = {
+        "131_01.bvh",
+        "131_02.bvh",
+        "131_03.bvh",
+    };
+
+    // Simulate a tick where many characters play the clip at different times and rates
+    constexpr int num_characters = 1000;
+
+    for (const std::string& file_path : file_paths)
+    {
+        const bvh11::BvhObject bvh(file_path);
+
+        const double duration = bvh.frames() * bvh.frame_time();
+
+        std::mt19937                           random_engine(0);
+        std::uniform_real_distribution<double> distribution(-0.5 * duration, 1.5 * duration);
+
+        std::vector<double> times(num_characters);
+        for (double& time : times)
+        {
+            time = distribution(random_engine);
+        }
+
+        // One pose per character, so that sampling is allocation-free after the first tick
+        std::vector<bvh11::Pose> poses(num_characters);
+
+        std::cout << file_path << " (" << bvh.GetJointList().size() << " joints)" << std::endl;
+
+        const std::vector<std::pair<std::string, bvh11::SamplingMode>> modes = {
+            {"clamp", bvh11::SamplingMode::clamp},
+            {"loop ", bvh11::SamplingMode::loop},
+        };
+        for (const auto& mode : modes)
+        {
+            const double seconds = benchutil::measure_seconds(
+                [&]()
+                {
+                    for (int i = 0; i < num_characters; ++i)
+                    {
+                        bvh.SamplePose(times[i], poses[i], mode.second);
+                    }
+                });
+
+            std::cout << "  SamplePose (" << mode.first << "): " << 1e9 * seconds / num_characters << " ns/sample"
+                      << std::endl;
+        }
+
+        // Reference: evaluating integer frames without interpolation
+        bvh11::TransformList transforms;
+        const double         frame_seconds = benchutil::measure_seconds(
+            [&]()
+            {
+                for (int i = 0; i < num_characters; ++i)
+                {
+                    bvh.ComputeGlobalTransforms(i % bvh.frames(), transforms);
+                }
+            });
+
+        std::cout << "  ComputeGlobalTransforms (integer frame): " << 1e9 * frame_seconds / num_characters
+                  << " ns/sample" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+    const double num_minutes     = (argc >= 2) ? std::atof(argv[1]) : 60.0;
+    const int    max_num_threads = (argc >= 3) ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+
+    // Make a long capture at 120 Hz by repeating the frames of a take
+    bvh11::BvhObject bvh("131_01.bvh");
+
+    const int num_original_frames = bvh.frames();
+    const int num_frames          = static_cast<int>(num_minutes * 60.0 / bvh.frame_time());
+
+    bvh.ResizeFrames(num_frames);
+    Eigen::MatrixXd& motion = bvh.mutable_motion();
+    for (int frame = num_original_frames; frame < num_frames; ++frame)
+    {
+        motion.row(frame) = motion.row(frame % num_original_frames);
+    }
+
+    const std::size_t motion_size = sizeof(double) * motion.size();
+
+    std::cout << "#Frames: " << num_frames << " (" << num_minutes << " min at " << 1.0 / bvh.frame_time()
+              << " Hz), #Channels: " << motion.cols() << std::endl;
+
+    for (const double frame_rate : {60.0, 30.0, 50.0})
+    {
+        double sequential_seconds = 0.0;
+        for (int num_threads = 1; num_threads <= std::max(1, max_num_threads); ++num_threads)
+        {
+            int num_resampled_frames = 0;
+
+            const double seconds = benchutil::measure_seconds(
+                [&]() { num_resampled_frames = bvh.Resample(1.0 / frame_rate, num_threads).frames(); }, 3);
+            if (num_threads == 1)
+            {
+                sequential_seconds = seconds;
+            }
+
+            benchutil::print_result(std::to_string(static_cast<int>(frame_rate)) + " Hz, " +
+                                        std::to_string(num_threads) + " thread(s)",
+                                    seconds,
+                                    motion_size);
+            std::cout << "  " << num_resampled_frames / seconds << " frames/s, speed-up: x"
+                      << sequential_seconds / seconds << std::endl;
+        }
+    }
+
+    return 0;
+}
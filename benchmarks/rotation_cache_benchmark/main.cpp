@@ -0,0 +1,64 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/pose.hpp>
+#include <iostream>
+
+namespace
+{
+    /// \brief Query every joint at every frame, and return the elapsed time.
+    double measure_queries(const bvh11::BvhObject& bvh, double& checksum)
+    {
+        const auto joints = bvh.GetJointList();
+
+        bvh11::TransformList transforms;
+        bvh11::Pose          pose;
+
+        return benchutil::measure_seconds(
+            [&]()
+            {
+                for (int frame = 0; frame < bvh.frames(); ++frame)
+                {
+                    for (const auto& joint : joints)
+                    {
+                        checksum += bvh.GetTransformation(joint, frame).translation().sum();
+                    }
+                    bvh.ComputeGlobalTransforms(frame, transforms);
+                    bvh.SamplePose((frame + 0.5) * bvh.frame_time(), pose);
+                }
+            });
+    }
+} // namespace
+
+int main()
+{
+    const std::vector<std::string> file_paths = {
+        "131_01.bvh",
+        "131_02.bvh",
+        "131_03.bvh",
+    };
+
+    for (const std::string& file_path : file_paths)
+    {
+        bvh11::BvhObject bvh(file_path);
+
+        double       checksum_direct = 0.0;
+        const double direct_seconds  = measure_queries(bvh, checksum_direct);
+
+        const double build_seconds = benchutil::measure_seconds([&]() { bvh.BuildRotationCache(); });
+
+        double       checksum_cached = 0.0;
+        const double cached_seconds  = measure_queries(bvh, checksum_cached);
+
+        std::cout << file_path << " (" << bvh.GetJointList().size() << " joints, " << bvh.frames() << " frames)"
+                  << std::endl;
+        std::cout << "  cache memory: " << bvh.rotation_cache_memory_bytes() / 1024.0 << " KiB (motion: "
+                  << bvh.motion().size() * sizeof(double) / 1024.0 << " KiB)" << std::endl;
+        std::cout << "  cache build: " << 1000.0 * build_seconds << " ms" << std::endl;
+        std::cout << "  queries without cache: " << 1000.0 * direct_seconds << " ms" << std::endl;
+        std::cout << "  queries with cache   : " << 1000.0 * cached_seconds << " ms" << std::endl;
+        std::cout << "  speed-up: x" << direct_seconds / cached_seconds << " (checksums: " << checksum_direct << ", "
+                  << checksum_cached << ")" << std::endl;
+    }
+
+    return 0;
+}
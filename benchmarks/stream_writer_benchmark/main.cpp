@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/stream-writer.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    /// \brief Append the frames one by one, optionally paced at a capture rate, and report the append latencies.
+    void run(const std::string&                label,
+             const bvh11::BvhObject&           bvh,
+             const std::string&                output_path,
+             const bvh11::StreamWriterOptions& options,
+             double                            frames_per_second)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<double> latencies(bvh.frames());
+        Eigen::VectorXd     values(bvh.channels().size());
+
+        const auto begin = Clock::now();
+        {
+            bvh11::BvhStreamWriter writer(output_path, bvh, options);
+            for (int frame = 0; frame < bvh.frames(); ++frame)
+            {
+                if (frames_per_second > 0.0)
+                {
+                    std::this_thread::sleep_until(begin + std::chrono::duration<double>(frame / frames_per_second));
+                }
+
+                values = bvh.motion().row(frame).transpose();
+
+                const auto append_begin = Clock::now();
+                writer.AppendFrame(values);
+                const auto append_end = Clock::now();
+
+                latencies[frame] = std::chrono::duration<double, std::micro>(append_end - append_begin).count();
+            }
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](const double p) -> double
+        { return latencies[std::min(bvh.frames() - 1, static_cast<int>(p * bvh.frames()))]; };
+
+        benchutil::print_result(label, seconds, benchutil::get_file_size(output_path));
+        std::cout << "    " << bvh.frames() / seconds << " frames/s, append latency (us): p50 " << percentile(0.5)
+                  << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999) << ", max "
+                  << latencies.back() << std::endl;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int    num_frames        = (argc >= 2) ? std::atoi(argv[1]) : 20000;
+    const int    num_joints        = (argc >= 3) ? std::atoi(argv[2]) : 101;
+    const double frames_per_second = (argc >= 4) ? std::atof(argv[3]) : 1000.0;
+
+    // Create a long synthetic clip
+    const std::string input_path  = "synthetic_stream_writer_benchmark.bvh";
+    const std::string output_path = "synthetic_stream_writer_benchmark_output.bvh";
+    benchutil::create_synthetic_bvh_file(input_path, num_joints, 10, num_frames);
+
+    bvh11::BvhObject bvh(input_path);
+    std::remove(input_path.c_str());
+
+    std::cout << "#Frames: " << bvh.frames() << ", #Joints: " << bvh.GetJointList().size() << std::endl;
+
+    // Reference: writing the whole clip at once
+    const double whole_seconds = benchutil::measure_seconds([&]() { bvh.WriteBvhFile(output_path); }, 3);
+    benchutil::print_result("WriteBvhFile (whole clip)", whole_seconds, benchutil::get_file_size(output_path));
+
+    // Appending as fast as possible, where small queues make the appending thread wait for the background thread
+    for (const int queue_capacity : {64, 1024, 16384})
+    {
+        bvh11::StreamWriterOptions options;
+        options.queue_capacity = queue_capacity;
+
+        run("BvhStreamWriter (burst, queue " + std::to_string(queue_capacity) + ")", bvh, output_path, options, 0.0);
+    }
+
+    // Appending at a capture rate, where the background thread keeps up and the appends never wait
+    const int num_paced_frames = std::min(bvh.frames(), static_cast<int>(2.0 * frames_per_second));
+    bvh.ResizeFrames(num_paced_frames);
+    run("BvhStreamWriter (" + std::to_string(static_cast<int>(frames_per_second)) + " fps)",
+        bvh,
+        output_path,
+        bvh11::StreamWriterOptions(),
+        frames_per_second);
+
+    std::remove(output_path.c_str());
+
+    return 0;
+}
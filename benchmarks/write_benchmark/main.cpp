@@ -0,0 +1,58 @@
+#include <bench-util.hpp>
+#include <bvh11.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+    const int num_frames      = (argc >= 2) ? std::atoi(argv[1]) : 20000;
+    const int num_joints      = (argc >= 3) ? std::atoi(argv[2]) : 101;
+    const int max_num_threads = (argc >= 4) ? std::atoi(argv[3]) : std::thread::hardware_concurrency();
+
+    // Create a long synthetic clip
+    const std::string input_path  = "synthetic_write_benchmark.bvh";
+    const std::string output_path = "synthetic_write_benchmark_output.bvh";
+    benchutil::create_synthetic_bvh_file(input_path, num_joints, 10, num_frames);
+
+    const bvh11::BvhObject bvh(input_path);
+    std::remove(input_path.c_str());
+
+    std::cout << "#Frames: " << bvh.frames() << ", #Joints: " << bvh.GetJointList().size() << std::endl;
+
+    // Reference: the motion written through iostreams with Eigen::IOFormat (the previous implementation)
+    const double stream_seconds = benchutil::measure_seconds(
+        [&]()
+        {
+            const Eigen::IOFormat format(Eigen::StreamPrecision, Eigen::DontAlignCols, " ", "", "", "\n", "", "");
+
+            std::ofstream ofs(output_path);
+            ofs << bvh.motion().format(format);
+        },
+        3);
+    benchutil::print_result("iostream (motion only)", stream_seconds, benchutil::get_file_size(output_path));
+
+    bvh11::WriteOptions fixed_options;
+    fixed_options.number_format  = bvh11::NumberFormat::fixed;
+    fixed_options.decimal_places = 4;
+
+    const double fixed_seconds =
+        benchutil::measure_seconds([&]() { bvh.WriteBvhFile(output_path, fixed_options); }, 3);
+    benchutil::print_result("fixed, 4 decimal places", fixed_seconds, benchutil::get_file_size(output_path));
+
+    for (int num_threads = 1; num_threads <= std::max(1, max_num_threads); ++num_threads)
+    {
+        bvh11::WriteOptions options;
+        options.num_threads = num_threads;
+
+        const double seconds = benchutil::measure_seconds([&]() { bvh.WriteBvhFile(output_path, options); }, 3);
+        const std::string label = "round trip, " + std::to_string(num_threads) + " thread(s)";
+        benchutil::print_result(label, seconds, benchutil::get_file_size(output_path));
+    }
+
+    std::remove(output_path.c_str());
+
+    return 0;
+}
@@ -3,48 +3,330 @@
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <list>
 #include <memory>
+#include <new>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace bvh11
 {
     struct Channel;
     class Joint;
+    class Skeleton;
+    struct Pose;
+    struct LoadStatistics;
+    class HierarchyArena;
+
+    using TransformList  = std::vector<Eigen::Affine3d, Eigen::aligned_allocator<Eigen::Affine3d>>;
+    using QuaternionList = std::vector<Eigen::Quaterniond, Eigen::aligned_allocator<Eigen::Quaterniond>>;
+
+    namespace internal
+    {
+        void* allocate_from_hierarchy_arena(HierarchyArena* arena, std::size_t size, std::size_t alignment);
+    } // namespace internal
+
+    /// \brief Allocator of the lists of a joint, which takes memory from the arena of the hierarchy if any, and from
+    ///        the heap otherwise.
+    /// \details Memory taken from an arena is not freed individually but together with the arena.
+    template <typename T>
+    class HierarchyAllocator
+    {
+    public:
+        using value_type = T;
+
+        explicit HierarchyAllocator(HierarchyArena* arena = nullptr) : arena_(arena) {}
+
+        template <typename U>
+        HierarchyAllocator(const HierarchyAllocator<U>& other) : arena_(other.arena())
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            void* memory = (arena_ != nullptr)
+                               ? internal::allocate_from_hierarchy_arena(arena_, n * sizeof(T), alignof(T))
+                               : ::operator new(n * sizeof(T));
+            return static_cast<T*>(memory);
+        }
+
+        void deallocate(T* pointer, std::size_t)
+        {
+            if (arena_ == nullptr)
+            {
+                ::operator delete(pointer);
+            }
+        }
+
+        HierarchyArena* arena() const { return arena_; }
+
+        template <typename U>
+        bool operator==(const HierarchyAllocator<U>& other) const
+        {
+            return arena_ == other.arena();
+        }
+
+        template <typename U>
+        bool operator!=(const HierarchyAllocator<U>& other) const
+        {
+            return arena_ != other.arena();
+        }
+
+    private:
+        HierarchyArena* arena_;
+    };
+
+    enum class FileFormat
+    {
+        /// \brief The standard BVH text format.
+        text,
+
+        /// \brief The binary format written by BvhObject::WriteBinaryFile.
+        binary
+    };
+
+    enum class HierarchyStorage
+    {
+        /// \brief Each joint and each of its lists is a separate heap allocation.
+        heap,
+
+        /// \brief The joints and their lists are allocated from a monotonic arena of the object, which is released
+        ///        at once with a few blocks. Pointers to the joints obtained from the object (e.g., root_joint(),
+        ///        GetJointList(), and the target joints of the channels) share the ownership of the arena, whereas
+        ///        the children of a joint do not.
+        arena
+    };
+
+    struct LoadOptions
+    {
+        /// \brief Format of the input file.
+        FileFormat format = FileFormat::text;
+
+        /// \brief Scale factor applied to offsets and translations.
+        double scale = 1.0;
+
+        /// \brief Whether to read the file directly from a read-only memory mapping instead of a stream.
+        /// \details When the file cannot be mapped (e.g., it is not a regular file or the platform does not support
+        ///          mmap), it is read through a stream as usual.
+        bool use_memory_mapping = false;
+
+        /// \brief Number of threads used for parsing the frames of the MOTION section.
+        /// \details One means sequential parsing, and zero means the number of hardware threads.
+        int num_threads = 1;
+
+        /// \brief How the joint hierarchy is stored.
+        HierarchyStorage hierarchy_storage = HierarchyStorage::heap;
+
+        /// \brief Statistics to which those of the load are added, or null (see bvh11/statistics.hpp).
+        /// \details They are recorded only if the library is built with BVH11_ENABLE_STATISTICS.
+        LoadStatistics* statistics = nullptr;
+    };
+
+    enum class NumberFormat
+    {
+        /// \brief The shortest decimal representation that is read back to exactly the same value.
+        shortest_round_trip,
+
+        /// \brief The value rounded to WriteOptions::decimal_places decimal places, omitting trailing zeros.
+        fixed
+    };
+
+    struct WriteOptions
+    {
+        /// \brief How the numbers are formatted.
+        NumberFormat number_format = NumberFormat::shortest_round_trip;
+
+        /// \brief Number of decimal places used by NumberFormat::fixed.
+        int decimal_places = 6;
+
+        /// \brief Number of threads used for formatting the frames of the MOTION section.
+        /// \details One means sequential formatting, and zero means the number of hardware threads.
+        int num_threads = 1;
+    };
+
+    enum class SamplingMode
+    {
+        /// \brief Times outside the clip are clamped to the first or the last frame.
+        clamp,
+
+        /// \brief The clip is repeated, where the last frame is interpolated back to the first frame; the period is
+        ///        frames() * frame_time().
+        loop
+    };
 
     class BvhObject
     {
     public:
+        /// \details A file that cannot be opened or has malformed contents is reported by std::runtime_error, whose
+        ///          message begins with the number of the offending line for parse errors.
         /// \param file_path Path to the input BVH file.
         BvhObject(const std::string& file_path, const double scale = 1.0) { ReadBvhFile(file_path, scale); }
 
+        /// \param file_path Path to the input BVH file.
+        BvhObject(const std::string& file_path, const LoadOptions& options) { ReadBvhFile(file_path, options); }
+
         int    frames() const { return frames_; }
         double frame_time() const { return frame_time_; }
 
         const std::vector<Channel>& channels() const { return channels_; }
         const Eigen::MatrixXd&      motion() const { return motion_; }
 
+        /// \brief Return the motion data for editing.
+        /// \details This clears the rotation cache and the constant channel analysis, since they may not match the
+        ///          edited values. Build them again after the edit if needed; do not keep the reference across
+        ///          BuildRotationCache() or AnalyzeConstantChannels().
+        Eigen::MatrixXd& mutable_motion()
+        {
+            ClearRotationCache();
+            ClearConstantChannelAnalysis();
+            return motion_;
+        }
+
         std::shared_ptr<const Joint> root_joint() const { return root_joint_; }
 
         /// \brief Return a list of all the joints.
         /// \return List of the joints sorted always in the same order.
-        std::vector<std::shared_ptr<const Joint>> GetJointList() const;
+        std::vector<std::shared_ptr<const Joint>> GetJointList() const { return joint_list_; }
+
+        /// \brief Return the index of the parent of each joint in the joint list.
+        /// \details The i-th element corresponds to the i-th joint of GetJointList(). Parents always precede their
+        ///          children, and the root joint has -1.
+        const std::vector<int>& parent_indices() const { return parent_indices_; }
+
+        /// \brief Return the compiled representation of the joint hierarchy (see bvh11/skeleton.hpp).
+        std::shared_ptr<const Skeleton> skeleton() const { return skeleton_; }
 
+        /// \brief Whether the other object has the same joint hierarchy (see Skeleton::IsEquivalent).
+        bool HasSameHierarchy(const BvhObject& other) const;
+
+        /// \brief Replace the joint hierarchy of this object with that of the other object.
+        /// \details Both objects then share the same joints, channels, and skeleton, so identical hierarchies of
+        ///          many clips are stored only once. The hierarchies must be the same (see HasSameHierarchy).
+        void ShareHierarchy(const BvhObject& other);
+
+        /// \return The index of the joint in GetJointList().
+        /// \details A joint that does not belong to this object throws std::invalid_argument.
+        int GetJointIndex(const std::shared_ptr<const Joint>& joint) const;
+
+        /// \details The joint may also belong to another object whose channels fit this motion (e.g., one with the
+        ///          same hierarchy); its channels are then evaluated one by one, and channel indices out of the range
+        ///          of channels() throw std::invalid_argument.
         /// \param frame Frame. This value must be between 0 and frames() - 1.
         Eigen::Affine3d GetTransformationRelativeToParent(std::shared_ptr<const Joint> joint, int frame) const;
 
+        /// \details The joint may also belong to another object as in GetTransformationRelativeToParent, in which case
+        ///          the chain of its own parents is followed.
         /// \param frame Frame. This value must be between 0 and frames() - 1.
         Eigen::Affine3d GetTransformation(std::shared_ptr<const Joint> joint, int frame) const;
 
         /// \param frame Frame. This value must be between 0 and frames() - 1.
         Eigen::Affine3d GetRootTransformation(int frame) const { return GetTransformation(root_joint_, frame); }
 
+        /// \brief Compute the transformations of all the joints at once.
+        /// \details This visits each joint only once by reusing the transformation of its parent, whereas calling
+        ///          GetTransformation for every joint recomputes the shared ancestors repeatedly.
+        /// \param frame Frame. This value must be between 0 and frames() - 1.
+        /// \param transforms Output transformations, where the i-th element is for the i-th joint of GetJointList().
+        void ComputeGlobalTransforms(int frame, TransformList& transforms) const;
+
+        /// \brief Compute the transformations of all the joints at once into an array of #joints elements.
+        void ComputeGlobalTransforms(int frame, Eigen::Affine3d* transforms) const;
+
+        /// \brief Compute the positions of all the joints for a range of frames at once.
+        /// \details This is vectorized across frames, so it is much faster than evaluating the frames one by one.
+        /// \param frame_begin First frame of the range.
+        /// \param frame_end Frame after the last frame of the range.
+        /// \return Matrix of size (3 * #joints) x (frame_end - frame_begin), whose memory layout is frames x joints
+        ///         x 3; i.e., the position of the j-th joint of GetJointList() at frame_begin + f is the segment of
+        ///         the f-th column starting from the (3 * j)-th row.
+        Eigen::MatrixXd ComputeGlobalPositions(int frame_begin, int frame_end) const;
+
+        /// \brief Precompute the local rotations of all the joints for all the frames as quaternions.
+        /// \details While the cache exists, GetTransformationRelativeToParent, GetTransformation,
+        ///          ComputeGlobalTransforms, and SamplePose read rotations from it instead of converting Euler angles.
+        ///          The cache stores frames() x #joints quaternions (see rotation_cache_memory_bytes()), and it is
+        ///          cleared by mutable_motion() and ResizeFrames().
+        /// \param num_threads Number of threads; zero means the number of hardware threads.
+        void BuildRotationCache(int num_threads = 1);
+
+        void ClearRotationCache() { rotation_cache_.clear(); }
+
+        bool has_rotation_cache() const { return !rotation_cache_.empty(); }
+
+        /// \return Memory used by the rotation cache in bytes.
+        std::size_t rotation_cache_memory_bytes() const { return rotation_cache_.size() * sizeof(Eigen::Quaterniond); }
+
+        /// \brief Return the cached local rotations of all the joints at the frame.
+        /// \return Pointer to an array of #joints quaternions in the order of GetJointList().
+        const Eigen::Quaterniond* GetCachedRotations(int frame) const;
+
+        /// \brief Find the channels whose values are constant over all the frames, and precompute the local
+        ///        transformations of the static joints (i.e., the joints all of whose channels are constant).
+        /// \details While the analysis exists, GetTransformationRelativeToParent, GetTransformation,
+        ///          ComputeGlobalTransforms, and ComputeGlobalPositions use the precomputed transformations of the
+        ///          static joints instead of evaluating their channels at every frame. The analysis is cleared by
+        ///          mutable_motion() and ResizeFrames().
+        /// \param tolerance Maximum difference from the value at the first frame for a channel to be constant. The
+        ///                  value at the first frame is used for all the frames, so zero keeps the results exact.
+        void AnalyzeConstantChannels(double tolerance = 0.0);
+
+        void ClearConstantChannelAnalysis();
+
+        bool has_constant_channel_analysis() const { return !static_joint_flags_.empty(); }
+
+        /// \brief Whether each channel is constant, in the order of channels(); empty without the analysis.
+        const std::vector<std::uint8_t>& constant_channel_flags() const { return constant_channel_flags_; }
+
+        /// \brief Whether each joint is static, in the order of GetJointList(); empty without the analysis.
+        /// \details A joint without channels is also static.
+        const std::vector<std::uint8_t>& static_joint_flags() const { return static_joint_flags_; }
+
+        /// \brief Estimate how much of motion() is redundant, i.e., the values of the constant channels at all but
+        ///        the first frame.
+        /// \details This is only an estimate of what storing the constant channels once could save; the analysis
+        ///          itself saves no memory, since motion() keeps all the values of every channel so that the editor,
+        ///          the writers, and resampling can index it directly.
+        /// \return The size of the redundant values in bytes, or zero without the analysis.
+        std::size_t EstimateRedundantMotionBytes() const;
+
+        /// \brief Sample the local transformations of all the joints at an arbitrary time.
+        /// \details Rotations are interpolated by slerp and translations (i.e., the root translation, or any
+        ///          translation channel) by linear interpolation between the two neighboring frames. This does not
+        ///          allocate memory if the pose already has the right size (see bvh11/pose.hpp).
+        /// \param time_seconds Time measured from the first frame, where the i-th frame is at i * frame_time().
+        /// \param pose Output pose.
+        void SamplePose(double time_seconds, Pose& pose, SamplingMode mode = SamplingMode::clamp) const;
+
+        /// \brief Create a copy of the object whose motion is resampled at a different frame rate.
+        /// \details The i-th new frame is sampled at i * frame_time within the duration of the original frames. The
+        ///          rotation of a joint is interpolated by slerp and converted back to the Euler angles that are the
+        ///          closest to the neighboring frames, so the angles do not jump by wrapping around. The other
+        ///          channels, including the channels of joints with nonstandard layouts, are interpolated one by one
+        ///          linearly (along the shorter way for angles). Frames that fall exactly on original frames are
+        ///          copied. The new object shares the joint hierarchy with this object.
+        /// \param frame_time Frame time of the new object in seconds (e.g., 1.0 / 30.0).
+        /// \param num_threads Number of threads; zero means the number of hardware threads.
+        BvhObject Resample(double frame_time, int num_threads = 1) const;
+
         void PrintJointHierarchy() const { PrintJointSubHierarchy(root_joint_, 0); }
 
+        /// \brief Write the data in the BVH text format.
+        /// \details The text is formatted into large buffers without iostreams and written with a few large writes.
+        ///          With the default options, reading the output gives exactly the same values.
         /// \param file_path Path to the output BVH file.
-        void WriteBvhFile(const std::string& file_path) const;
+        void WriteBvhFile(const std::string& file_path, const WriteOptions& options = WriteOptions()) const;
+
+        /// \brief Write the data in a compact binary format, which can be loaded much faster than the text format.
+        /// \details The file contains a versioned header, the hierarchy, the channels, the frame time, and the motion
+        ///          data as a raw contiguous block. It is loaded by specifying FileFormat::binary in LoadOptions. The
+        ///          byte order is that of the writing machine; loading a file of another byte order or version, or a
+        ///          truncated file, throws std::runtime_error. Loading copies the motion block once into motion(),
+        ///          also with use_memory_mapping, since motion() owns its values.
+        /// \param file_path Path to the output binary file.
+        void WriteBinaryFile(const std::string& file_path) const;
 
         /// \brief Change the number of the frames.
         /// \details When the specified number is larger than the current number, it adds new frames at the end
@@ -63,11 +345,64 @@ namespace bvh11
 
         std::shared_ptr<const Joint> root_joint_;
 
+        std::vector<std::shared_ptr<const Joint>> joint_list_;
+        std::unordered_map<const Joint*, int>     joint_indices_;
+        std::vector<int>                          parent_indices_;
+        std::shared_ptr<const Skeleton>           skeleton_;
+
+        /// \brief Arena of the joints, or null if the hierarchy is stored on the heap (see HierarchyStorage).
+        std::shared_ptr<HierarchyArena> hierarchy_arena_;
+
+        /// \brief Local rotations of the joints stored frame by frame (i.e., frames x joints), or empty.
+        QuaternionList rotation_cache_;
+
+        /// \brief Result of AnalyzeConstantChannels, where the transformations are only valid for the static joints.
+        std::vector<std::uint8_t> constant_channel_flags_;
+        std::vector<std::uint8_t> static_joint_flags_;
+        TransformList             static_local_transforms_;
+
+        /// \brief Create an object that shares the hierarchy of the other object and has uninitialized frames.
+        BvhObject(const BvhObject& other, int frames, double frame_time);
+
+        /// \brief Create an object that shares the hierarchy of the other object and parses only the MOTION section.
+        /// \param motion_begin Beginning of the "Frames:" line.
+        /// \param first_line_number Number of the line before motion_begin in the file, which is used for parse
+        ///                          errors.
+        BvhObject(const BvhObject&   other,
+                  const char*        motion_begin,
+                  const char*        motion_end,
+                  std::uint64_t      first_line_number,
+                  const LoadOptions& options);
+
+        /// \brief Create an object by parsing BVH text in memory (e.g., a whole file read or mapped by the caller).
+        BvhObject(const char* text_begin, const char* text_end, const LoadOptions& options);
+
         void ReadBvhFile(const std::string& file_path, const double scale = 1.0);
+        void ReadBvhFile(const std::string& file_path, const LoadOptions& options);
+        void ReadTextFile(const std::string& file_path, const LoadOptions& options);
+        void ReadText(const char* text_begin, const char* text_end, const LoadOptions& options);
+        void ReadBinaryFile(const std::string& file_path, const LoadOptions& options);
 
-        void PrintJointSubHierarchy(std::shared_ptr<const Joint> joint, int depth) const;
+        void FlattenHierarchy();
+
+        /// \return The index of the joint in GetJointList(), or -1 if it does not belong to this object.
+        int FindJointIndex(const Joint* joint) const;
 
-        void WriteJointSubHierarchy(std::ofstream& ofs, std::shared_ptr<const Joint> joint, int depth) const;
+        Eigen::Affine3d ComputeLocalTransform(int joint_index, int frame) const;
+
+        /// \brief Prepare the hierarchy storage, call the function that reads the data, and build the joint list.
+        template <typename ReadFunction>
+        void Load(const LoadOptions& options, ReadFunction read);
+
+        template <typename LineReader>
+        void ReadSections(LineReader& reader, const LoadOptions& options);
+
+        template <typename LineReader>
+        void ReadMotionSection(LineReader& reader, const LoadOptions& options);
+
+        friend class BvhLibrary;
+
+        void PrintJointSubHierarchy(std::shared_ptr<const Joint> joint, int depth) const;
     };
 
     struct Channel
@@ -91,7 +426,18 @@ namespace bvh11
     class Joint
     {
     public:
-        Joint(const std::string& name, std::shared_ptr<Joint> parent) : name_(name), parent_(parent) {}
+        using ChildList        = std::vector<std::shared_ptr<Joint>, HierarchyAllocator<std::shared_ptr<Joint>>>;
+        using ChannelIndexList = std::vector<int, HierarchyAllocator<int>>;
+
+        /// \param arena Arena from which the lists of the joint are allocated, or null for the heap (see
+        ///              HierarchyStorage).
+        Joint(const std::string& name, std::shared_ptr<Joint> parent, HierarchyArena* arena = nullptr)
+            : name_(name),
+              parent_(parent),
+              children_(HierarchyAllocator<std::shared_ptr<Joint>>(arena)),
+              associated_channels_indices_(HierarchyAllocator<int>(arena))
+        {
+        }
 
         const Eigen::Vector3d& offset() const { return offset_; }
         Eigen::Vector3d&       offset() { return offset_; }
@@ -104,23 +450,28 @@ namespace bvh11
 
         const std::string& name() const { return name_; }
 
-        const std::list<std::shared_ptr<Joint>>& children() const { return children_; }
-        const std::list<int>& associated_channels_indices() const { return associated_channels_indices_; }
+        /// \details The children do not share the ownership of the joints when the hierarchy is stored in an arena;
+        ///          keep the object or a pointer from GetJointList() or root_joint() while using them.
+        const ChildList&        children() const { return children_; }
+        const ChannelIndexList& associated_channels_indices() const { return associated_channels_indices_; }
 
-        std::shared_ptr<Joint> parent() const { return parent_; }
+        /// \return The parent, or null for the root joint (or if the parent has already been destroyed).
+        std::shared_ptr<Joint> parent() const { return parent_.lock(); }
 
-        void AddChild(std::shared_ptr<Joint> child) { children_.push_back(child); }
+        void AddChild(std::shared_ptr<Joint> child);
         void AssociateChannel(int channel_index) { associated_channels_indices_.push_back(channel_index); }
 
     private:
-        const std::string            name_;
-        const std::shared_ptr<Joint> parent_;
-
-        bool                              has_end_site_ = false;
-        Eigen::Vector3d                   end_site_;
-        Eigen::Vector3d                   offset_;
-        std::list<std::shared_ptr<Joint>> children_;
-        std::list<int>                    associated_channels_indices_;
+        const std::string name_;
+
+        /// \brief Weak reference to the parent, since the parent owns this joint through its children.
+        const std::weak_ptr<Joint> parent_;
+
+        bool             has_end_site_ = false;
+        Eigen::Vector3d  end_site_;
+        Eigen::Vector3d  offset_;
+        ChildList        children_;
+        ChannelIndexList associated_channels_indices_;
     };
 } // namespace bvh11
 
@@ -0,0 +1,52 @@
+#ifndef BVH11_ALLOCATION_COUNTING_HPP_
+#define BVH11_ALLOCATION_COUNTING_HPP_
+
+// Replacements of the global allocation functions that count the allocations of each thread for
+// LoadStatistics::num_allocations. This is opt-in for applications: include this header in exactly one source file of
+// the program (never in a library), and only if nothing else in the program replaces these functions. The memory is
+// managed by malloc and free as in the default implementations. Over-aligned allocations (C++17) keep the default
+// functions and are not counted.
+
+#include <bvh11/statistics.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t size)
+{
+    bvh11::CountAllocation();
+
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    bvh11::CountAllocation();
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return ::operator new(size, tag); }
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef BVH11_CLIP_EVALUATOR_HPP_
+#define BVH11_CLIP_EVALUATOR_HPP_
+
+#include <bvh11.hpp>
+#include <memory>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        class ThreadPool;
+    } // namespace internal
+
+    enum class ExecutionPolicy
+    {
+        /// \brief Evaluate all the frames on the calling thread.
+        sequential,
+
+        /// \brief Evaluate chunks of frames on worker threads that take the next chunk as soon as they finish one.
+        /// \details The workers are started once when the evaluator is constructed and sleep between evaluations, so
+        ///          evaluating a few frames at a time (e.g., every frame of a playback) does not pay for starting
+        ///          threads. Evaluations with the same evaluator are serialized.
+        thread_pool,
+
+        /// \brief Evaluate chunks of frames with an OpenMP dynamic schedule.
+        /// \details When the library is built without OpenMP, this behaves the same as thread_pool.
+        openmp
+    };
+
+    struct ClipEvaluationOptions
+    {
+        /// \brief How the frames are distributed over threads.
+        ExecutionPolicy policy = ExecutionPolicy::thread_pool;
+
+        /// \brief Number of threads used by the parallel policies; zero means the number of hardware threads.
+        int num_threads = 0;
+
+        /// \brief Number of consecutive frames handled by a single task.
+        int chunk_size = 64;
+    };
+
+    /// \brief Evaluator of the global transformations of all the joints for many frames of a BVH object.
+    /// \details Frames are independent, so they are split into chunks that are dynamically assigned to threads. Each
+    ///          chunk writes only its own part of a preallocated output buffer, so no locking is involved. Each frame
+    ///          is evaluated by BvhObject::ComputeGlobalTransforms, so the rotation cache and the constant channel
+    ///          analysis of the object are used if they exist. The object must outlive the evaluator.
+    class ClipEvaluator
+    {
+    public:
+        explicit ClipEvaluator(const BvhObject&             bvh,
+                               const ClipEvaluationOptions& options = ClipEvaluationOptions());
+
+        int num_joints() const { return num_joints_; }
+
+        const ClipEvaluationOptions& options() const { return options_; }
+
+        /// \brief Compute the transformations of all the joints for the frames in [frame_begin, frame_end).
+        /// \param transforms Pointer to an array of (frame_end - frame_begin) * num_joints() transformations. The
+        ///                   transformation of the j-th joint of GetJointList() at frame_begin + f is stored at
+        ///                   index f * num_joints() + j.
+        void Evaluate(int frame_begin, int frame_end, Eigen::Affine3d* transforms) const;
+
+        /// \brief Compute the transformations of all the joints for the frames in [frame_begin, frame_end).
+        /// \details This does not allocate memory if the list already has the required number of elements.
+        void Evaluate(int frame_begin, int frame_end, TransformList& transforms) const;
+
+        /// \brief Compute the transformations of all the joints for all the frames.
+        void Evaluate(TransformList& transforms) const { Evaluate(0, bvh_.frames(), transforms); }
+
+    private:
+        const BvhObject&      bvh_;
+        ClipEvaluationOptions options_;
+        int                   num_joints_;
+
+        /// \brief Workers for the thread_pool policy (nullptr for the other policies or a single thread).
+        std::shared_ptr<internal::ThreadPool> thread_pool_;
+    };
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef BVH11_COMPRESSED_MOTION_HPP_
+#define BVH11_COMPRESSED_MOTION_HPP_
+
+#include <bvh11.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace bvh11
+{
+    struct CompressionOptions
+    {
+        /// \brief Maximum error of the positions of the joints and the end sites in world units.
+        /// \details The error is measured by forward kinematics on the skeleton after compression.
+        double max_position_error = 0.1;
+
+        /// \brief Whether to store the rotation of each joint as a quaternion in the smallest-three encoding instead
+        ///        of three Euler angle channels.
+        /// \details Decompressed channel values are then converted back to Euler angles, which may differ from the
+        ///          original angles while representing the same rotations (see CompressedMotion::DecompressFrame).
+        bool use_quaternions = false;
+    };
+
+    /// \brief Lossy, compact representation of the motion data of a BVH object.
+    /// \details Each channel (or each joint rotation when quaternions are used) is stored as a track of keys, which are
+    ///          quantized to 16 bits after normalizing the range of the track. Keys are reduced by fitting piecewise
+    ///          linear curves within error tolerances that are derived from the maximum position error and the lengths
+    ///          of the bones. Frames are grouped into blocks of 256 frames that start with a key, so a frame can be
+    ///          decompressed without decoding the other frames.
+    ///
+    ///          A channel whose quantized values alone exceed its tolerance is stored raw (i.e., as the original double
+    ///          values), and so is a joint rotation in the channels instead of the quaternion encoding. If the error
+    ///          bound still cannot be met, all the channels are stored raw, so max_measured_error() never exceeds
+    ///          the bound.
+    class CompressedMotion
+    {
+    public:
+        explicit CompressedMotion(const BvhObject& bvh, const CompressionOptions& options = CompressionOptions());
+
+        int    frames() const { return frames_; }
+        double frame_time() const { return frame_time_; }
+        int    num_channels() const { return num_channels_; }
+
+        std::shared_ptr<const Skeleton> skeleton() const { return skeleton_; }
+
+        /// \brief Decompress the values of all the channels at the frame.
+        /// \details The Euler angles of a rotation track are chosen to be the closest to the angles in the output
+        ///          vector when it already has num_channels() elements (e.g., the previously decompressed frame), and
+        ///          otherwise to the original angles at the first frame. Sequential decompression into the same vector
+        ///          therefore gives continuous angles without jumps of 360 degrees or flips between the two sets of the
+        ///          angles of a rotation.
+        /// \param values Output vector. This does not allocate memory if it already has num_channels() elements.
+        void DecompressFrame(int frame, Eigen::VectorXd& values) const;
+
+        /// \brief Decompress the local transformations of all the joints at the frame.
+        /// \details This does not allocate memory if the pose and the buffer already have the right sizes.
+        /// \param values Buffer for the values of the channels, which is resized to num_channels() elements.
+        void DecompressPose(int frame, Pose& pose, Eigen::VectorXd& values) const;
+
+        /// \return Motion data in the same layout as BvhObject::motion() (i.e., frames x channels).
+        Eigen::MatrixXd Decompress() const;
+
+        std::size_t compressed_size_bytes() const;
+        std::size_t uncompressed_size_bytes() const { return sizeof(double) * frames_ * num_channels_; }
+
+        /// \return The maximum position error of the joints and the end sites measured at construction.
+        double max_measured_error() const { return max_measured_error_; }
+
+        /// \return The number of the channels stored raw because quantization could not meet their tolerances.
+        int num_raw_channels() const;
+
+    private:
+        /// \brief Keys of either a single channel or the rotation of a joint.
+        struct Track
+        {
+            /// \brief Index of the first channel, or the index of the joint for a rotation track.
+            int index;
+
+            bool is_rotation;
+
+            /// \brief Whether the channel values are stored as they are in raw_values instead of keys.
+            bool is_raw;
+
+            /// \brief Range of the values of a channel track used for the quantization.
+            double minimum;
+            double extent;
+
+            /// \brief Original Euler angles of a rotation track at the first frame in degrees.
+            Eigen::Vector3d initial_angles;
+
+            /// \brief Values of a raw channel track at all the frames.
+            std::vector<double> raw_values;
+
+            /// \brief Index of the first key of each block (and the total number of the keys at the end).
+            std::vector<std::uint32_t> block_key_begins;
+
+            /// \brief Frame of each key relative to the beginning of its block.
+            std::vector<std::uint8_t> key_offsets;
+
+            /// \brief Quantized values of the keys; a rotation key has three values.
+            std::vector<std::uint16_t> key_values;
+        };
+
+        std::shared_ptr<const Skeleton> skeleton_;
+
+        int    frames_;
+        double frame_time_;
+        int    num_channels_;
+
+        std::vector<Track> tracks_;
+
+        /// \brief Index of the rotation track of each joint, or -1 if the rotation is stored in channel tracks.
+        std::vector<int> rotation_track_indices_;
+
+        double max_measured_error_;
+
+        /// \brief Rebuild the tracks; a tolerance of zero makes the corresponding channels lossless.
+        void BuildTracks(const Eigen::MatrixXd&     motion,
+                         const QuaternionList&      rotations,
+                         const std::vector<double>& channel_tolerances,
+                         const std::vector<double>& rotation_tolerances,
+                         bool                       use_quaternions);
+
+        double DecodeChannel(const Track& track, int frame) const;
+
+        Eigen::Quaterniond DecodeRotation(const Track& track, int frame) const;
+    };
+} // namespace bvh11
+
+#endif
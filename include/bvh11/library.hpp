@@ -0,0 +1,67 @@
+#ifndef BVH11_LIBRARY_HPP_
+#define BVH11_LIBRARY_HPP_
+
+#include <bvh11.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bvh11
+{
+    /// \brief Collection of BVH clips loaded from many files at once.
+    /// \details Files are loaded concurrently by a pool of worker threads, where each worker loads whole files. Clips
+    ///          whose hierarchies are the same (i.e., the same joint names, offsets, end sites, and channel layout)
+    ///          share a single joint hierarchy and a single immutable skeleton. A file that cannot be loaded does
+    ///          not abort the batch; instead, its clip is null and the reason is reported by error_message().
+    ///
+    ///          Before parsing, each file is checked to be readable and to begin with the HIERARCHY keyword (or the
+    ///          binary signature for FileFormat::binary). Malformed contents beyond these checks are reported by the
+    ///          parser with their line numbers (see BvhObject). A text file whose HIERARCHY section is the same text
+    ///          as that of an already loaded file is not parsed again; only its MOTION section is.
+    ///          Each text file is read only once, from a memory mapping with LoadOptions::use_memory_mapping or into
+    ///          a buffer otherwise, and the lookup of the hierarchy and the parse share these bytes.
+    class BvhLibrary
+    {
+    public:
+        /// \param options Options used for loading each file. Its num_threads is applied within each file, so one is
+        ///                usually the best choice when there are more files than threads.
+        /// \param num_threads Number of threads loading files concurrently; zero means the number of hardware
+        ///                    threads.
+        explicit BvhLibrary(const std::vector<std::string>& file_paths,
+                            const LoadOptions&              options     = LoadOptions(),
+                            int                             num_threads = 0);
+
+        /// \return The number of the files, including the files that failed to be loaded.
+        int size() const { return static_cast<int>(file_paths_.size()); }
+
+        const std::string& file_path(int index) const { return file_paths_[index]; }
+
+        bool is_loaded(int index) const { return clips_[index] != nullptr; }
+
+        /// \return The loaded clip, or nullptr if the file failed to be loaded.
+        std::shared_ptr<const BvhObject> clip(int index) const { return clips_[index]; }
+
+        /// \return The reason of the failure, or an empty string if the file was loaded.
+        const std::string& error_message(int index) const { return error_messages_[index]; }
+
+        int num_loaded_clips() const;
+
+        /// \return The number of the distinct hierarchies among the loaded clips.
+        int num_hierarchies() const { return static_cast<int>(skeletons_.size()); }
+
+        /// \return The index of the hierarchy of the clip, or -1 if the file failed to be loaded.
+        int hierarchy_index(int index) const { return hierarchy_indices_[index]; }
+
+        /// \return The skeleton shared by all the clips of the hierarchy.
+        std::shared_ptr<const Skeleton> skeleton(int hierarchy_index) const { return skeletons_[hierarchy_index]; }
+
+    private:
+        std::vector<std::string>                      file_paths_;
+        std::vector<std::shared_ptr<const BvhObject>> clips_;
+        std::vector<std::string>                      error_messages_;
+        std::vector<int>                              hierarchy_indices_;
+        std::vector<std::shared_ptr<const Skeleton>>  skeletons_;
+    };
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef BVH11_MOTION_DATABASE_HPP_
+#define BVH11_MOTION_DATABASE_HPP_
+
+#include <bvh11.hpp>
+#include <memory>
+#include <vector>
+
+namespace bvh11
+{
+    struct FeatureOptions
+    {
+        /// \brief Indices of the joints (in the order of BvhObject::GetJointList()) whose positions are features.
+        std::vector<int> joint_indices;
+
+        /// \brief Whether to add the velocities of the joints as features.
+        /// \details Velocities are computed by finite differences within each clip, in units per second.
+        bool include_velocities = true;
+
+        /// \brief Whether to express the features in the local space of the root joint instead of the world space.
+        /// \details This makes the features invariant to where the character is and which direction it faces.
+        bool use_root_space = true;
+
+        /// \brief Number of threads; zero means the number of hardware threads.
+        int num_threads = 0;
+    };
+
+    /// \brief Result of a nearest-frame search.
+    struct NearestFrame
+    {
+        /// \brief Index of the frame in the database, or -1 if the database is empty.
+        int frame;
+
+        double squared_distance;
+    };
+
+    /// \brief Motion data of many clips of the same skeleton concatenated into a single matrix.
+    /// \details The frames of the clips are stored one after another in a single column-major matrix with the same
+    ///          layout as BvhObject::motion(), so each channel of all the frames is contiguous. Per-frame features
+    ///          are also stored column by column (i.e., as a structure of arrays), so that a brute-force search
+    ///          streams through contiguous memory and is vectorized across frames.
+    class MotionDatabase
+    {
+    public:
+        /// \param clips Clips to be concatenated. They must have the same hierarchy (see
+        ///              BvhObject::HasSameHierarchy); e.g., the clips of a hierarchy of BvhLibrary.
+        explicit MotionDatabase(const std::vector<std::shared_ptr<const BvhObject>>& clips);
+
+        std::shared_ptr<const Skeleton> skeleton() const { return skeleton_; }
+
+        int num_clips() const { return static_cast<int>(frame_times_.size()); }
+        int num_frames() const { return static_cast<int>(motion_.rows()); }
+
+        /// \brief Motion data of all the clips (#frames x #channels).
+        const Eigen::MatrixXd& motion() const { return motion_; }
+
+        /// \return The index of the first frame of the clip in the database.
+        int clip_frame_begin(int clip_index) const { return clip_frame_begins_[clip_index]; }
+
+        /// \return The index of the frame after the last frame of the clip in the database.
+        int clip_frame_end(int clip_index) const { return clip_frame_begins_[clip_index + 1]; }
+
+        double clip_frame_time(int clip_index) const { return frame_times_[clip_index]; }
+
+        /// \return The index of the clip that contains the frame of the database.
+        int GetClipIndex(int frame) const;
+
+        /// \brief Compute the features of all the frames.
+        /// \details For each joint of the options, the features are x, y, and z of the position, followed by x, y,
+        ///          and z of the velocities of all the joints if requested.
+        void ComputeFeatures(const FeatureOptions& options);
+
+        int num_features() const { return static_cast<int>(features_.cols()); }
+
+        /// \brief Features of all the frames (#frames x #features), where each feature is a contiguous column.
+        const Eigen::MatrixXd& features() const { return features_; }
+
+        /// \brief Find the frame whose features are the closest to the query by brute force.
+        /// \details Frames are split into chunks; within a chunk, the squared distances are accumulated feature by
+        ///          feature over contiguous columns into a buffer on the stack, so a query does not allocate. Small
+        ///          databases are searched on the calling thread, and larger ones on a process-wide pool of persistent
+        ///          threads, whose runs are serialized (pass one thread when querying from several threads at once).
+        /// \param query Features of the query, which has num_features() elements.
+        /// \param weights Weights of the squared differences of the features, or an empty vector for uniform weights.
+        /// \param num_threads Number of threads; zero means the number of hardware threads.
+        NearestFrame FindNearestFrame(const Eigen::VectorXd& query,
+                                      const Eigen::VectorXd& weights     = Eigen::VectorXd(),
+                                      int                    num_threads = 0) const;
+
+    private:
+        std::shared_ptr<const Skeleton> skeleton_;
+
+        Eigen::MatrixXd     motion_;
+        std::vector<int>    clip_frame_begins_;
+        std::vector<double> frame_times_;
+
+        Eigen::MatrixXd features_;
+    };
+} // namespace bvh11
+
+#endif
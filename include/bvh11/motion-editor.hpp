@@ -0,0 +1,70 @@
+#ifndef BVH11_MOTION_EDITOR_HPP_
+#define BVH11_MOTION_EDITOR_HPP_
+
+#include <bvh11.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace bvh11
+{
+    /// \brief Editor of the motion data of a BVH object that keeps the global transformations of the joints cached.
+    /// \details The global transformations are cached for every frame and recomputed lazily. Writing a channel marks
+    ///          the subtree of its joint as dirty at that frame; as GetJointList() is in depth-first order, a subtree
+    ///          is a contiguous range of joint indices. Only the dirty joints are recomputed at the next query, so a
+    ///          small edit does not cost a whole forward kinematics sweep. Edits must be made through this class (not
+    ///          through BvhObject::mutable_motion()) while it is in use; the object must outlive the editor.
+    class MotionEditor
+    {
+    public:
+        explicit MotionEditor(BvhObject& bvh);
+
+        const BvhObject& bvh() const { return bvh_; }
+
+        int num_joints() const { return static_cast<int>(subtree_ends_.size()); }
+
+        double GetChannelValue(int frame, int channel_index) const { return bvh_.motion()(frame, channel_index); }
+
+        /// \brief Write the value of a channel, and mark the subtree of the joint of the channel as dirty.
+        void SetChannelValue(int frame, int channel_index, double value);
+
+        /// \brief Change the number of the frames (see BvhObject::ResizeFrames). New frames are uninitialized.
+        void ResizeFrames(int num_new_frames);
+
+        /// \brief Mark all the joints of all the frames as dirty (e.g., after the motion was edited elsewhere).
+        void InvalidateAll();
+
+        /// \return The transformation of the joint relative to the world, updated if needed.
+        const Eigen::Affine3d& GetTransformation(int joint_index, int frame);
+
+        /// \return Pointer to the transformations of all the joints at the frame (in the order of GetJointList()),
+        ///         updated if needed.
+        const Eigen::Affine3d* GetTransformations(int frame);
+
+        /// \return The total number of the joints whose transformations have been (re)computed.
+        std::size_t num_evaluated_joints() const { return num_evaluated_joints_; }
+
+    private:
+        BvhObject& bvh_;
+
+        /// \brief Index after the last joint of the subtree of each joint.
+        std::vector<int> subtree_ends_;
+
+        /// \brief Index of the joint that each channel belongs to.
+        std::vector<int> channel_joint_indices_;
+
+        /// \brief Cached global transformations (frames x joints).
+        TransformList transforms_;
+
+        /// \brief Dirty flags of the cached transformations (frames x joints).
+        std::vector<std::uint8_t> dirty_flags_;
+
+        /// \brief Smallest index of the dirty joints of each frame, or num_joints() if the frame is clean.
+        std::vector<int> first_dirty_joints_;
+
+        std::size_t num_evaluated_joints_;
+
+        void UpdateFrame(int frame);
+    };
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef BVH11_POSE_INDEX_HPP_
+#define BVH11_POSE_INDEX_HPP_
+
+#include <bvh11/motion-database.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bvh11
+{
+    struct PoseSearchOptions
+    {
+        /// \brief Maximum number of the leaves visited per query, or zero for the exact search.
+        /// \details Leaves are visited in the order of their lower bounds of the distance, so a small number of visits
+        ///          usually finds the nearest frame or one almost as near.
+        int max_leaf_visits = 0;
+
+        /// \brief Number of threads used for batched queries; zero means the number of hardware threads.
+        int num_threads = 0;
+    };
+
+    /// \brief Spatial index of per-frame feature vectors for fast nearest-frame queries (e.g., for motion matching).
+    /// \details Frames are stored in a small number of k-d trees. Adding frames builds a new tree and merges it with
+    ///          the existing trees of at most the same size, so the number of the trees stays logarithmic in the
+    ///          number of the frames and each frame is rebuilt only a logarithmic number of times.
+    ///
+    ///          Each tree is a flat array of nodes referring to each other by index, and the feature vectors are
+    ///          stored contiguously in the order of the leaves, so a leaf is scanned as a single block of memory.
+    ///          The file written by WriteFile consists of these arrays aligned to 64 bytes. Loading it copies each
+    ///          array once into memory owned by the index instead of rebuilding the trees; the file is not kept
+    ///          mapped.
+    class PoseIndex
+    {
+    public:
+        explicit PoseIndex(int num_features);
+
+        /// \brief Load an index written by WriteFile.
+        /// \details A file of another format, of another version, or written with another byte order, or a file
+        ///          whose trees are inconsistent (e.g., nodes referring to nonexistent nodes or points), throws
+        ///          std::runtime_error.
+        explicit PoseIndex(const std::string& file_path);
+
+        int num_features() const { return num_features_; }
+        int num_trees() const { return static_cast<int>(trees_.size()); }
+
+        /// \return The number of the indexed frames.
+        int size() const;
+
+        /// \brief Add the frames of a feature matrix, such as MotionDatabase::features().
+        /// \param features Features of the frames (#frames x num_features()).
+        /// \param first_frame Index reported for the first row; the i-th row is reported as first_frame + i.
+        void AddFrames(const Eigen::MatrixXd& features, int first_frame = 0);
+
+        /// \brief Find the frame whose features are the closest to the query.
+        NearestFrame FindNearestFrame(const Eigen::VectorXd&   query,
+                                      const PoseSearchOptions& options = PoseSearchOptions()) const;
+
+        /// \brief Find the nearest frames of many queries concurrently.
+        /// \param queries Features of the queries (#queries x num_features()).
+        /// \param results Output results; the i-th element is for the i-th row of the queries.
+        void FindNearestFrames(const Eigen::MatrixXd&     queries,
+                               std::vector<NearestFrame>& results,
+                               const PoseSearchOptions&   options = PoseSearchOptions()) const;
+
+        void WriteFile(const std::string& file_path) const;
+
+    private:
+        using RowMajorMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+        /// \brief Node of a k-d tree; the left child of an internal node always follows the node.
+        struct Node
+        {
+            double split_value;
+
+            /// \brief Dimension of the split, or -1 for a leaf.
+            std::int32_t split_dimension;
+
+            std::int32_t right_child;
+
+            /// \brief Range of the points under the node.
+            std::int32_t begin;
+            std::int32_t end;
+        };
+
+        struct Tree
+        {
+            std::vector<Node> nodes;
+
+            /// \brief Feature vectors in the order of the leaves (#points x #features).
+            RowMajorMatrixXd points;
+
+            std::vector<std::int32_t> frames;
+        };
+
+        /// \brief Reusable work memory of a query.
+        struct SearchBuffers;
+
+        int               num_features_;
+        std::vector<Tree> trees_;
+
+        /// \brief Build a tree over the points, which are reordered into the order of the leaves.
+        static Tree BuildTree(RowMajorMatrixXd points, std::vector<std::int32_t> frames);
+
+        /// \brief Check that the nodes of a loaded tree refer only to the nodes, the points, and the features that
+        ///        exist, so that a corrupt file cannot make Search read out of bounds; throws std::runtime_error.
+        static void ValidateTree(const Tree& tree, int num_features);
+
+        NearestFrame Search(const double* query, const PoseSearchOptions& options, SearchBuffers& buffers) const;
+    };
+} // namespace bvh11
+
+#endif
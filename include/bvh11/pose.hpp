@@ -0,0 +1,49 @@
+#ifndef BVH11_POSE_HPP_
+#define BVH11_POSE_HPP_
+
+#include <bvh11.hpp>
+#include <vector>
+
+namespace bvh11
+{
+    /// \brief Local transformations of all the joints at a certain time.
+    /// \details The i-th elements are for the i-th joint of BvhObject::GetJointList(), and they are relative to the
+    ///          parent joint. A pose can be reused for sampling many times; once it has the right size, sampling does
+    ///          not allocate memory, so keeping one pose per thread (or per character) makes sampling allocation-free.
+    struct Pose
+    {
+        QuaternionList               rotations;
+        std::vector<Eigen::Vector3d> translations;
+
+        int num_joints() const { return static_cast<int>(rotations.size()); }
+
+        Eigen::Affine3d GetLocalTransform(int joint_index) const
+        {
+            Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+            transform.translation()   = translations[joint_index];
+            transform.linear()        = rotations[joint_index].toRotationMatrix();
+            return transform;
+        }
+
+        /// \brief Compute the transformations of all the joints relative to the world.
+        /// \details This does not allocate memory if the list already has num_joints() elements.
+        void ComputeGlobalTransforms(const std::vector<int>& parent_indices, TransformList& transforms) const
+        {
+            transforms.resize(num_joints());
+            for (int joint_index = 0; joint_index < num_joints(); ++joint_index)
+            {
+                const int parent_index = parent_indices[joint_index];
+                if (parent_index < 0)
+                {
+                    transforms[joint_index] = GetLocalTransform(joint_index);
+                }
+                else
+                {
+                    transforms[joint_index] = transforms[parent_index] * GetLocalTransform(joint_index);
+                }
+            }
+        }
+    };
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef BVH11_SKELETON_HPP_
+#define BVH11_SKELETON_HPP_
+
+#include <bvh11.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bvh11
+{
+    /// \brief Layout of the rotation channels of a joint.
+    /// \details The name lists the axes in the order of the channels; e.g., zxy means "Zrotation Xrotation
+    ///          Yrotation", whose rotation is Rz * Rx * Ry.
+    enum class RotationOrder : std::uint8_t
+    {
+        xyz,
+        xzy,
+        yxz,
+        yzx,
+        zxy,
+        zyx,
+
+        /// \brief The joint has no channel.
+        none,
+
+        /// \brief The channels do not follow the standard layouts, so they are processed one by one.
+        generic
+    };
+
+    /// \brief Compiled, immutable representation of a joint hierarchy.
+    /// \details Joints are stored in the order of BvhObject::GetJointList() as a structure of arrays, so evaluating
+    ///          the hierarchy needs neither pointer chasing, reference counting, nor heap allocation. A joint has
+    ///          either three rotation channels, three translation channels followed by three rotation channels,
+    ///          or no channel; other layouts are marked as RotationOrder::generic and handled channel by channel.
+    class Skeleton
+    {
+    public:
+        explicit Skeleton(const BvhObject& bvh);
+
+        int num_joints() const { return static_cast<int>(parent_indices_.size()); }
+        int num_channels() const { return static_cast<int>(channel_types_.size()); }
+
+        const std::vector<std::string>& names() const { return names_; }
+        const std::vector<int>&         parent_indices() const { return parent_indices_; }
+
+        /// \brief Offsets of the joints, where each column is for a joint.
+        const Eigen::Matrix3Xd& offsets() const { return offsets_; }
+
+        /// \brief End site offsets of the joints, where each column is for a joint. Only valid if has_end_sites().
+        const Eigen::Matrix3Xd&          end_sites() const { return end_sites_; }
+        const std::vector<std::uint8_t>& has_end_sites() const { return has_end_sites_; }
+
+        const std::vector<int>&           channel_starts() const { return channel_starts_; }
+        const std::vector<int>&           channel_counts() const { return channel_counts_; }
+        const std::vector<RotationOrder>& rotation_orders() const { return rotation_orders_; }
+
+        /// \brief Whether the joint has translation channels, which replace its offset.
+        const std::vector<std::uint8_t>& has_translation_channels() const { return has_translation_channels_; }
+
+        const std::vector<Channel::Type>& channel_types() const { return channel_types_; }
+
+        /// \return The index of the joint with the name, or -1 if there is no such joint.
+        int FindJoint(const std::string& name) const;
+
+        /// \brief Whether the other skeleton has the same joint names, parents, offsets, end sites, and channels.
+        /// \details Offsets are compared exactly, so hierarchies that were written with different precisions are
+        ///          considered different.
+        bool IsEquivalent(const Skeleton& other) const;
+
+        /// \brief Compute the transformation of a joint relative to its parent.
+        /// \param values Pointer to the value of the first channel of the frame.
+        /// \param stride Distance between the values of consecutive channels. For a frame of a column-major motion
+        ///               matrix (frames x channels), this is the number of the frames.
+        Eigen::Affine3d ComputeLocalTransform(int joint_index, const double* values, Eigen::Index stride = 1) const;
+
+        /// \brief Compute the rotation of a joint relative to its parent.
+        /// \details This gives the same rotation as ComputeLocalTransform, but directly as a quaternion.
+        Eigen::Quaterniond ComputeLocalRotation(int joint_index, const double* values, Eigen::Index stride = 1) const;
+
+        /// \brief Compute the translation of a joint relative to its parent (i.e., its offset or its translation
+        ///        channels).
+        Eigen::Vector3d ComputeLocalTranslation(int joint_index, const double* values, Eigen::Index stride = 1) const;
+
+        /// \brief Compute the transformations of all the joints in a single sweep.
+        /// \param motion Motion data (frames x channels) as in BvhObject::motion().
+        /// \param transforms Pointer to an array of num_joints() transformations.
+        void ComputeGlobalTransforms(const Eigen::MatrixXd& motion, int frame, Eigen::Affine3d* transforms) const;
+
+        /// \brief Compute the transformations of all the joints in a single sweep.
+        /// \details This does not allocate memory if the list already has num_joints() elements.
+        void ComputeGlobalTransforms(const Eigen::MatrixXd& motion, int frame, TransformList& transforms) const;
+
+        /// \brief Compute the positions of all the joints for a range of frames.
+        /// \details Frames are processed in small batches where each channel is a contiguous per-frame stream, so
+        ///          the trigonometric functions and the matrix compositions are vectorized across frames.
+        /// \param positions Output matrix of size (3 * num_joints()) x (frame_end - frame_begin). The column for a
+        ///                  frame stores x, y, and z of each joint, so the memory layout is frames x joints x 3.
+        void ComputeGlobalPositions(const Eigen::MatrixXd& motion,
+                                    int                    frame_begin,
+                                    int                    frame_end,
+                                    Eigen::MatrixXd&       positions) const;
+
+    private:
+        std::vector<std::string> names_;
+        std::vector<int>         parent_indices_;
+
+        Eigen::Matrix3Xd          offsets_;
+        Eigen::Matrix3Xd          end_sites_;
+        std::vector<std::uint8_t> has_end_sites_;
+
+        std::vector<int>           channel_starts_;
+        std::vector<int>           channel_counts_;
+        std::vector<RotationOrder> rotation_orders_;
+        std::vector<std::uint8_t>  has_translation_channels_;
+
+        std::vector<Channel::Type> channel_types_;
+
+        Eigen::Affine3d ComputeGenericLocalTransform(int joint_index, const double* values, Eigen::Index stride) const;
+    };
+} // namespace bvh11
+
+#endif
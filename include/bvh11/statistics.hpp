@@ -0,0 +1,88 @@
+#ifndef BVH11_STATISTICS_HPP_
+#define BVH11_STATISTICS_HPP_
+
+#include <cstdint>
+
+namespace bvh11
+{
+    /// \brief Whether the library is built with the statistics (the CMake option BVH11_ENABLE_STATISTICS).
+    /// \details Without it, no statistics are recorded, and the recording code is removed at compile time.
+    constexpr bool is_statistics_enabled()
+    {
+#ifdef BVH11_ENABLE_STATISTICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// \brief Statistics of loading files, which are recorded when LoadOptions::statistics points to an instance.
+    /// \details The values of each load are added to the instance, so it can accumulate the statistics of many files.
+    ///          An instance must not be used by concurrent loads (BvhLibrary gathers those of its files by itself).
+    struct LoadStatistics
+    {
+        /// \brief Number of the loaded files.
+        std::uint64_t num_files = 0;
+
+        /// \brief Size of the read data in bytes.
+        std::uint64_t num_bytes = 0;
+
+        /// \brief Number of the parsed lines, including the frame lines (text files only).
+        std::uint64_t num_lines = 0;
+
+        /// \brief Number of the parsed whitespace-delimited tokens, including the values (text files only).
+        std::uint64_t num_tokens = 0;
+
+        /// \brief Number of the heap allocations made by the loading thread.
+        /// \details Allocations are counted through CountAllocation, so this stays zero unless the application opts
+        ///          in (e.g., by including bvh11/allocation-counting.hpp).
+        std::uint64_t num_allocations = 0;
+
+        /// \brief Time spent reading the HIERARCHY section (or the hierarchy block of a binary file).
+        double hierarchy_seconds = 0.0;
+
+        /// \brief Time spent reading the MOTION section (or the motion block of a binary file).
+        double motion_seconds = 0.0;
+
+        /// \brief Time spent scaling the translation channels.
+        double scaling_seconds = 0.0;
+
+        /// \brief Time spent building the joint list and the skeleton.
+        double flattening_seconds = 0.0;
+
+        /// \brief Total time of the loads, including opening the files.
+        double total_seconds = 0.0;
+
+        LoadStatistics& operator+=(const LoadStatistics& other);
+    };
+
+    /// \brief Statistics of the forward kinematics computed by BvhObject (i.e., GetTransformationRelativeToParent,
+    ///        GetTransformation, ComputeGlobalTransforms, and ComputeGlobalPositions) and by PlaybackMotion (i.e.,
+    ///        ComputeGlobalTransforms and ComputeGlobalPositions).
+    struct KinematicsStatistics
+    {
+        /// \brief Number of the calls.
+        std::uint64_t num_calls = 0;
+
+        /// \brief Number of the evaluated local transformations (i.e., joints x frames).
+        std::uint64_t num_local_transforms = 0;
+
+        /// \brief Time spent in the calls.
+        double seconds = 0.0;
+    };
+
+    /// \return The statistics of the forward kinematics called on this thread since the last reset.
+    KinematicsStatistics GetKinematicsStatistics();
+
+    /// \brief Reset the statistics of the forward kinematics of this thread.
+    void ResetKinematicsStatistics();
+
+    /// \brief Count a heap allocation of this thread in LoadStatistics::num_allocations.
+    /// \details The library never replaces the global allocation functions, since that would clash with applications
+    ///          and allocator libraries that replace them. Instead, an application that wants the counts calls this
+    ///          from its own allocation functions or allocator hooks, or includes bvh11/allocation-counting.hpp in one
+    ///          of its source files. This does nothing without the statistics.
+    void CountAllocation() noexcept;
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef BVH11_STREAM_READER_HPP_
+#define BVH11_STREAM_READER_HPP_
+
+#include <bvh11.hpp>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace bvh11
+{
+    struct StreamReaderOptions
+    {
+        /// \brief Scale factor applied to offsets and translations.
+        double scale = 1.0;
+
+        /// \brief Interval of the frame lines whose byte offsets are indexed, which must be positive.
+        /// \details Frames are decoded in blocks of this number of frames.
+        int index_interval = 16;
+
+        /// \brief Maximum number of decoded frames kept in memory.
+        int cache_capacity = 1024;
+    };
+
+    /// \brief Reader that decodes frames of a BVH file on demand.
+    /// \details The hierarchy is parsed eagerly, but the MOTION section is only indexed at construction; the memory
+    ///          usage is bounded by the index (one offset per index_interval frames) and the frame cache rather than
+    ///          by the file size. This class is not thread-safe because decoding reads the file and updates the cache.
+    class BvhStreamReader
+    {
+    public:
+        /// \details Throws std::invalid_argument if the index interval is not positive.
+        /// \param file_path Path to the input BVH file. It needs to be seekable.
+        BvhStreamReader(const std::string& file_path, const StreamReaderOptions& options = StreamReaderOptions());
+
+        int    frames() const { return frames_; }
+        double frame_time() const { return frame_time_; }
+
+        const std::vector<Channel>& channels() const { return channels_; }
+
+        std::shared_ptr<const Joint> root_joint() const { return root_joint_; }
+
+        /// \param frame Frame. This value must be between 0 and frames() - 1.
+        /// \return Values of all the channels at the frame.
+        Eigen::VectorXd GetFrame(int frame);
+
+        /// \brief Decode the frames in [frame_begin, frame_end).
+        /// \return Motion data in the same layout as BvhObject::motion() (i.e., frames x channels).
+        Eigen::MatrixXd ReadFrameRange(int frame_begin, int frame_end);
+
+        /// \return Number of the decoded frames currently kept in the cache.
+        int num_cached_frames() const { return num_cached_frames_; }
+
+    private:
+        StreamReaderOptions options_;
+
+        int    frames_;
+        double frame_time_;
+
+        std::vector<Channel>         channels_;
+        std::shared_ptr<const Joint> root_joint_;
+
+        std::ifstream ifs_;
+        std::string   buffer_;
+
+        /// \brief Number of the lines before the first frame line, which is used for parse errors.
+        std::uint64_t num_header_lines_ = 0;
+
+        /// \brief Byte offsets of every index_interval-th frame line, followed by the end of the last frame line.
+        std::vector<std::int64_t> block_offsets_;
+
+        /// \brief Decoded blocks ordered from the most recently used one.
+        std::list<std::pair<int, Eigen::MatrixXd>>                                    cached_blocks_;
+        std::unordered_map<int, std::list<std::pair<int, Eigen::MatrixXd>>::iterator> cache_table_;
+
+        /// \brief Total number of the rows of the cached blocks, where the last block may be shorter than the interval.
+        int num_cached_frames_ = 0;
+
+        void IndexFrames();
+
+        const Eigen::MatrixXd& GetBlock(int block_index);
+    };
+} // namespace bvh11
+
+#endif
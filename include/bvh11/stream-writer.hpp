@@ -0,0 +1,118 @@
+#ifndef BVH11_STREAM_WRITER_HPP_
+#define BVH11_STREAM_WRITER_HPP_
+
+#include <atomic>
+#include <bvh11.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bvh11
+{
+    struct StreamWriterOptions
+    {
+        /// \brief How the numbers are formatted; num_threads is ignored because the frames are formatted by the
+        ///        background thread of the writer.
+        WriteOptions write_options;
+
+        /// \brief Maximum number of the frames waiting to be written.
+        /// \details Appending a frame blocks (or TryAppendFrame fails) while the queue is full.
+        int queue_capacity = 4096;
+    };
+
+    /// \brief Writer that records a BVH file incrementally while the frames are being produced (e.g., live capture).
+    /// \details The hierarchy is written at construction. Appended frames are copied into a bounded single-producer
+    ///          single-consumer ring buffer, from which a background thread formats and writes them, so the appending
+    ///          thread only pays for the copy unless the queue is full. The text is flushed whenever the queue becomes
+    ///          empty, so the file stays close to the latest frame.
+    ///
+    ///          The number of the frames is unknown until the end, so the "Frames:" line is written with a
+    ///          fixed-width placeholder and patched by Close. Frames must be appended from one thread at a time.
+    class BvhStreamWriter
+    {
+    public:
+        /// \details Throws std::runtime_error if the file cannot be opened.
+        /// \param file_path Path to the output BVH file.
+        /// \param bvh_object Object whose hierarchy, channels, and frame time are written; its frames are ignored.
+        BvhStreamWriter(const std::string&         file_path,
+                        const BvhObject&           bvh_object,
+                        const StreamWriterOptions& options = StreamWriterOptions());
+
+        /// \brief Close the writer if it is still open, ignoring write errors (call Close to detect them).
+        ~BvhStreamWriter();
+
+        BvhStreamWriter(const BvhStreamWriter&)            = delete;
+        BvhStreamWriter& operator=(const BvhStreamWriter&) = delete;
+
+        int num_channels() const { return num_channels_; }
+
+        /// \return The number of the frames appended so far.
+        int num_appended_frames() const { return static_cast<int>(tail_.load(std::memory_order_relaxed)); }
+
+        bool is_open() const { return writer_thread_.joinable(); }
+
+        /// \return Whether writing to the file has failed so far (e.g., the disk is full); the remaining frames are
+        ///         still consumed but discarded, and Close reports the failure.
+        bool has_failed() const { return has_failed_.load(); }
+
+        /// \brief Append a frame, waiting for space while the queue is full.
+        /// \param values Values of all the channels (in the same order as BvhObject::channels()).
+        void AppendFrame(const double* values);
+        void AppendFrame(const Eigen::VectorXd& values);
+
+        /// \brief Append a frame only if the queue has space.
+        /// \return Whether the frame was appended.
+        bool TryAppendFrame(const Eigen::VectorXd& values);
+
+        /// \brief Append frames in the same layout as BvhObject::motion() (i.e., frames x channels).
+        void AppendFrames(const Eigen::MatrixXd& frames);
+
+        /// \brief Write the remaining frames, patch the number of the frames, and close the file.
+        /// \details Throws std::runtime_error if any write has failed; the writer is closed either way.
+        void Close();
+
+    private:
+        std::ofstream ofs_;
+
+        /// \brief Byte offset of the placeholder of the number of the frames.
+        std::streamoff frames_offset_;
+
+        WriteOptions write_options_;
+
+        int           num_channels_;
+        std::uint64_t capacity_;
+
+        /// \brief Ring buffer of the queued frames (capacity x channels).
+        std::vector<double> slots_;
+
+        /// \brief Index of the next frame to be written, which is only advanced by the background thread.
+        alignas(64) std::atomic<std::uint64_t> head_;
+
+        /// \brief Index of the next frame to be appended, which is only advanced by the appending thread.
+        alignas(64) std::atomic<std::uint64_t> tail_;
+
+        /// \brief Copy of head_ seen by the appending thread; it is reloaded only when the queue looks full.
+        std::uint64_t cached_head_;
+
+        /// \brief Set by the background thread when the stream has failed.
+        std::atomic<bool> has_failed_;
+
+        std::atomic<bool>       is_closing_;
+        std::atomic<bool>       is_writer_waiting_;
+        std::mutex              mutex_;
+        std::condition_variable condition_;
+        std::thread             writer_thread_;
+
+        /// \brief Wake up the background thread if it is waiting for frames.
+        void Notify();
+
+        /// \brief Body of the background thread.
+        void WriteFrames();
+    };
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,12 @@
+#include "batch-kinematics.hpp"
+
+namespace bvh11
+{
+    void Skeleton::ComputeGlobalPositions(const Eigen::MatrixXd& motion,
+                                          int                    frame_begin,
+                                          int                    frame_end,
+                                          Eigen::MatrixXd&       positions) const
+    {
+        internal::compute_global_positions(*this, motion, frame_begin, frame_end, positions);
+    }
+} // namespace bvh11
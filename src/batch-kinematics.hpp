@@ -0,0 +1,410 @@
+#ifndef BVH11_BATCH_KINEMATICS_HPP_
+#define BVH11_BATCH_KINEMATICS_HPP_
+
+#include <algorithm>
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Number of the frames processed together.
+        /// \details Frames are the innermost dimension of every array, so the element-wise operations below are
+        ///          vectorized by Eigen using the available SIMD instructions (or scalar code if there is none).
+        constexpr int frame_batch_size = 32;
+
+        template <typename Scalar>
+        using FrameBatch = Eigen::Array<Scalar, frame_batch_size, 1>;
+
+        /// \brief Dynamic matrix of a scalar type, such as motion data (frames x channels) or positions.
+        template <typename Scalar>
+        using MotionMatrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+        /// \brief Rigid transformations of a joint for a batch of frames.
+        template <typename Scalar>
+        struct BatchTransform
+        {
+            EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+            FrameBatch<Scalar> rotation[3][3];
+            FrameBatch<Scalar> translation[3];
+        };
+
+        template <typename Scalar>
+        using BatchTransformList =
+            std::vector<BatchTransform<Scalar>, Eigen::aligned_allocator<BatchTransform<Scalar>>>;
+
+        /// \brief Load the values of a channel for a batch of frames, padding the rest with zeros.
+        /// \details Values stored in a narrower type are widened to the type of the computation.
+        template <typename StorageScalar, typename Scalar>
+        inline void load_channel(const MotionMatrix<StorageScalar>& motion,
+                                 const int                          channel_index,
+                                 const int                          frame_begin,
+                                 const int                          num_frames,
+                                 FrameBatch<Scalar>&                values)
+        {
+            using StorageBatch = Eigen::Array<StorageScalar, frame_batch_size, 1>;
+            using StorageArray = Eigen::Array<StorageScalar, Eigen::Dynamic, 1>;
+
+            const StorageScalar* column = motion.data() + channel_index * motion.rows() + frame_begin;
+            if (num_frames == frame_batch_size)
+            {
+                values = Eigen::Map<const StorageBatch>(column).template cast<Scalar>();
+            }
+            else
+            {
+                values.head(num_frames) = Eigen::Map<const StorageArray>(column, num_frames).template cast<Scalar>();
+                values.tail(frame_batch_size - num_frames).setZero();
+            }
+        }
+
+        /// \brief Compute the sines and cosines of angles in degrees with element-wise operations only.
+        /// \details The range reduction is done in degrees, where multiples of 90 are exact, and rounding adds and
+        ///          subtracts 1.5 * 2^(#mantissa bits) so that every step maps to SIMD instructions. The reduced angles
+        ///          are in [-pi/4, pi/4], where the polynomials (in the Horner order) are evaluated.
+        template <typename Scalar, int NumCoefficients>
+        inline void compute_sine_cosine(const FrameBatch<Scalar>& degrees,
+                                        const Scalar              rounding_constant,
+                                        const Scalar (&sine_coefficients)[NumCoefficients],
+                                        const Scalar (&cosine_coefficients)[NumCoefficients],
+                                        FrameBatch<Scalar>&       sine,
+                                        FrameBatch<Scalar>&       cosine)
+        {
+            using Batch = FrameBatch<Scalar>;
+
+            // Reduce the angles into [-45, 45] degrees, and find the quadrants
+            const Batch quarter_turns = (degrees / Scalar(90) + rounding_constant) - rounding_constant;
+            const Batch x             = Scalar(M_PI / 180.0) * (degrees - Scalar(90) * quarter_turns);
+            const Batch z             = x * x;
+
+            const Batch full_turns =
+                ((quarter_turns / Scalar(4) - Scalar(0.375)) + rounding_constant) - rounding_constant;
+            const Batch quadrant = quarter_turns - Scalar(4) * full_turns;
+
+            Batch sine_polynomial   = Batch::Constant(sine_coefficients[0]);
+            Batch cosine_polynomial = Batch::Constant(cosine_coefficients[0]);
+            for (int k = 1; k < NumCoefficients; ++k)
+            {
+                sine_polynomial   = sine_polynomial * z + sine_coefficients[k];
+                cosine_polynomial = cosine_polynomial * z + cosine_coefficients[k];
+            }
+
+            const Batch reduced_sine   = x + x * z * sine_polynomial;
+            const Batch reduced_cosine = Scalar(1) - Scalar(0.5) * z + z * z * cosine_polynomial;
+
+            // Map the values back to the quadrants
+            const auto is_swapped         = (quadrant - Scalar(2)).abs() == Scalar(1);
+            const auto is_sine_negative   = quadrant >= Scalar(2);
+            const auto is_cosine_negative = (quadrant - Scalar(1.5)).abs() == Scalar(0.5);
+
+            sine   = is_swapped.select(reduced_cosine, reduced_sine);
+            cosine = is_swapped.select(reduced_sine, reduced_cosine);
+            sine   = is_sine_negative.select(-sine, sine);
+            cosine = is_cosine_negative.select(-cosine, cosine);
+        }
+
+        /// \details Eigen does not vectorize std::sin and std::cos for double precision, so they are evaluated with
+        ///          the minimax polynomials of the Cephes library (sin and cos).
+        inline void compute_sine_cosine(const FrameBatch<double>& degrees,
+                                        FrameBatch<double>&       sine,
+                                        FrameBatch<double>&       cosine)
+        {
+            constexpr double sine_coefficients[6]   = {1.58962301576546568060e-10,
+                                                       -2.50507477628578072866e-8,
+                                                       2.75573136213857245213e-6,
+                                                       -1.98412698295895385996e-4,
+                                                       8.33333333332211858878e-3,
+                                                       -1.66666666666666307295e-1};
+            constexpr double cosine_coefficients[6] = {-1.13585365213876817300e-11,
+                                                       2.08757008419747316778e-9,
+                                                       -2.75573141792967388112e-7,
+                                                       2.48015872888517045348e-5,
+                                                       -1.38888888888730564116e-3,
+                                                       4.16666666666665929218e-2};
+
+            compute_sine_cosine(degrees, 6755399441055744.0, sine_coefficients, cosine_coefficients, sine, cosine);
+        }
+
+        /// \details Single precision needs only the shorter polynomials of the Cephes library (sinf and cosf), so
+        ///          twice as many frames fit in a SIMD register and half as many terms are evaluated.
+        inline void compute_sine_cosine(const FrameBatch<float>& degrees,
+                                        FrameBatch<float>&       sine,
+                                        FrameBatch<float>&       cosine)
+        {
+            constexpr float sine_coefficients[3]   = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+            constexpr float cosine_coefficients[3] = {2.4433157118e-5f, -1.3887316255e-3f, 4.1666645683e-2f};
+
+            compute_sine_cosine(degrees, 12582912.0f, sine_coefficients, cosine_coefficients, sine, cosine);
+        }
+
+        template <typename Scalar>
+        inline void set_identity_rotation(BatchTransform<Scalar>& transform)
+        {
+            for (int row = 0; row < 3; ++row)
+            {
+                for (int col = 0; col < 3; ++col)
+                {
+                    transform.rotation[row][col].setConstant(row == col ? Scalar(1) : Scalar(0));
+                }
+            }
+        }
+
+        /// \brief Batched version of set_axis_rotation in rotation-kernels.hpp.
+        template <int Axis, typename Scalar>
+        inline void set_axis_rotation(BatchTransform<Scalar>&   transform,
+                                      const FrameBatch<Scalar>& cosine,
+                                      const FrameBatch<Scalar>& sine)
+        {
+            constexpr int i = (Axis + 1) % 3;
+            constexpr int j = (Axis + 2) % 3;
+
+            set_identity_rotation(transform);
+            transform.rotation[i][i] = cosine;
+            transform.rotation[j][j] = cosine;
+            transform.rotation[j][i] = sine;
+            transform.rotation[i][j] = -sine;
+        }
+
+        /// \brief Batched version of apply_axis_rotation in rotation-kernels.hpp.
+        template <int Axis, typename Scalar>
+        inline void apply_axis_rotation(BatchTransform<Scalar>&   transform,
+                                        const FrameBatch<Scalar>& cosine,
+                                        const FrameBatch<Scalar>& sine)
+        {
+            constexpr int i = (Axis + 1) % 3;
+            constexpr int j = (Axis + 2) % 3;
+
+            for (int row = 0; row < 3; ++row)
+            {
+                const FrameBatch<Scalar> element_i = transform.rotation[row][i];
+
+                transform.rotation[row][i] = cosine * element_i + sine * transform.rotation[row][j];
+                transform.rotation[row][j] = cosine * transform.rotation[row][j] - sine * element_i;
+            }
+        }
+
+        template <int Axis0, int Axis1, int Axis2, typename Scalar>
+        inline void set_euler_rotation(BatchTransform<Scalar>& transform, const FrameBatch<Scalar> (&angles)[3])
+        {
+            FrameBatch<Scalar> sine;
+            FrameBatch<Scalar> cosine;
+
+            compute_sine_cosine(angles[0], sine, cosine);
+            set_axis_rotation<Axis0>(transform, cosine, sine);
+
+            compute_sine_cosine(angles[1], sine, cosine);
+            apply_axis_rotation<Axis1>(transform, cosine, sine);
+
+            compute_sine_cosine(angles[2], sine, cosine);
+            apply_axis_rotation<Axis2>(transform, cosine, sine);
+        }
+
+        /// \brief Set the same transformation for all the frames of the batch.
+        template <typename Scalar>
+        inline void set_constant_transform(BatchTransform<Scalar>& transform, const Eigen::Affine3d& constant)
+        {
+            for (int row = 0; row < 3; ++row)
+            {
+                for (int col = 0; col < 3; ++col)
+                {
+                    transform.rotation[row][col].setConstant(static_cast<Scalar>(constant.linear()(row, col)));
+                }
+                transform.translation[row].setConstant(static_cast<Scalar>(constant.translation()(row)));
+            }
+        }
+
+        /// \brief Compute parent * local and store it into the output.
+        template <typename Scalar>
+        inline void compose(const BatchTransform<Scalar>& parent,
+                            const BatchTransform<Scalar>& local,
+                            BatchTransform<Scalar>&       output)
+        {
+            for (int row = 0; row < 3; ++row)
+            {
+                for (int col = 0; col < 3; ++col)
+                {
+                    output.rotation[row][col] = parent.rotation[row][0] * local.rotation[0][col] +
+                                                parent.rotation[row][1] * local.rotation[1][col] +
+                                                parent.rotation[row][2] * local.rotation[2][col];
+                }
+                output.translation[row] = parent.rotation[row][0] * local.translation[0] +
+                                          parent.rotation[row][1] * local.translation[1] +
+                                          parent.rotation[row][2] * local.translation[2] + parent.translation[row];
+            }
+        }
+
+        /// \brief Compute the transformation of a joint with a non-standard channel layout (see
+        ///        RotationOrder::generic) in double precision.
+        inline Eigen::Affine3d compute_generic_local_transform(const Skeleton&        skeleton,
+                                                               const int              joint_index,
+                                                               const Eigen::MatrixXd& motion,
+                                                               const int              frame,
+                                                               Eigen::VectorXd&)
+        {
+            return skeleton.ComputeLocalTransform(joint_index, motion.data() + frame, motion.rows());
+        }
+
+        /// \details The channels of the joint are widened into the buffer first, which is rarely needed, so the
+        ///          generic kernel of Skeleton is shared by all the storage types.
+        template <typename StorageScalar>
+        inline Eigen::Affine3d compute_generic_local_transform(const Skeleton&                    skeleton,
+                                                               const int                          joint_index,
+                                                               const MotionMatrix<StorageScalar>& motion,
+                                                               const int                          frame,
+                                                               Eigen::VectorXd&                   buffer)
+        {
+            const int channel_start = skeleton.channel_starts()[joint_index];
+            const int channel_end   = channel_start + skeleton.channel_counts()[joint_index];
+
+            buffer.resize(motion.cols());
+            for (int channel_index = channel_start; channel_index < channel_end; ++channel_index)
+            {
+                buffer(channel_index) = static_cast<double>(motion(frame, channel_index));
+            }
+            return skeleton.ComputeLocalTransform(joint_index, buffer.data());
+        }
+
+        /// \brief Batched forward kinematics behind Skeleton::ComputeGlobalPositions.
+        /// \details The motion is stored in StorageScalar and the kinematics is computed in Scalar, so a single
+        ///          precision computation processes twice as many frames per SIMD instruction.
+        /// \param static_joint_flags Whether each joint is static (see BvhObject::AnalyzeConstantChannels), or null.
+        /// \param static_local_transforms Local transformations used for the static joints at every frame.
+        template <typename StorageScalar, typename Scalar>
+        void compute_global_positions(const Skeleton&                    skeleton,
+                                      const MotionMatrix<StorageScalar>& motion,
+                                      int                                frame_begin,
+                                      int                                frame_end,
+                                      MotionMatrix<Scalar>&              positions,
+                                      const std::uint8_t*                static_joint_flags      = nullptr,
+                                      const Eigen::Affine3d*             static_local_transforms = nullptr)
+        {
+            assert(0 <= frame_begin && frame_begin <= frame_end && frame_end <= motion.rows() &&
+                   "Invalid frame range.");
+            assert(motion.cols() == skeleton.num_channels() && "The motion does not match the skeleton.");
+
+            const int num_joints = skeleton.num_joints();
+
+            positions.resize(3 * num_joints, frame_end - frame_begin);
+
+            BatchTransform<Scalar>     local;
+            BatchTransformList<Scalar> globals(num_joints);
+            Eigen::VectorXd            generic_buffer;
+
+            for (int batch_begin = frame_begin; batch_begin < frame_end; batch_begin += frame_batch_size)
+            {
+                const int num_frames = std::min(frame_batch_size, frame_end - batch_begin);
+
+                for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+                {
+                    const int           channel_start = skeleton.channel_starts()[joint_index];
+                    const RotationOrder order         = skeleton.rotation_orders()[joint_index];
+
+                    // Compute the local transformations
+                    if (static_joint_flags != nullptr && static_joint_flags[joint_index])
+                    {
+                        set_constant_transform(local, static_local_transforms[joint_index]);
+                    }
+                    else if (order == RotationOrder::generic)
+                    {
+                        // Evaluate joints with non-standard layouts frame by frame
+                        for (int i = 0; i < num_frames; ++i)
+                        {
+                            const Eigen::Affine3d transform = compute_generic_local_transform(
+                                skeleton, joint_index, motion, batch_begin + i, generic_buffer);
+                            for (int row = 0; row < 3; ++row)
+                            {
+                                for (int col = 0; col < 3; ++col)
+                                {
+                                    local.rotation[row][col](i) = static_cast<Scalar>(transform.linear()(row, col));
+                                }
+                                local.translation[row](i) = static_cast<Scalar>(transform.translation()(row));
+                            }
+                        }
+                    }
+                    else
+                    {
+                        int rotation_start = channel_start;
+                        if (skeleton.has_translation_channels()[joint_index])
+                        {
+                            for (int row = 0; row < 3; ++row)
+                            {
+                                load_channel(
+                                    motion, channel_start + row, batch_begin, num_frames, local.translation[row]);
+                            }
+                            rotation_start += 3;
+                        }
+                        else
+                        {
+                            for (int row = 0; row < 3; ++row)
+                            {
+                                local.translation[row].setConstant(
+                                    static_cast<Scalar>(skeleton.offsets()(row, joint_index)));
+                            }
+                        }
+
+                        FrameBatch<Scalar> angles[3];
+                        if (order != RotationOrder::none)
+                        {
+                            for (int k = 0; k < 3; ++k)
+                            {
+                                load_channel(motion, rotation_start + k, batch_begin, num_frames, angles[k]);
+                            }
+                        }
+
+                        switch (order)
+                        {
+                            case RotationOrder::xyz:
+                                set_euler_rotation<0, 1, 2>(local, angles);
+                                break;
+                            case RotationOrder::xzy:
+                                set_euler_rotation<0, 2, 1>(local, angles);
+                                break;
+                            case RotationOrder::yxz:
+                                set_euler_rotation<1, 0, 2>(local, angles);
+                                break;
+                            case RotationOrder::yzx:
+                                set_euler_rotation<1, 2, 0>(local, angles);
+                                break;
+                            case RotationOrder::zxy:
+                                set_euler_rotation<2, 0, 1>(local, angles);
+                                break;
+                            case RotationOrder::zyx:
+                                set_euler_rotation<2, 1, 0>(local, angles);
+                                break;
+                            case RotationOrder::none:
+                            case RotationOrder::generic:
+                                set_identity_rotation(local);
+                                break;
+                        }
+                    }
+
+                    // Compose them with the global transformations of the parents
+                    const int parent_index = skeleton.parent_indices()[joint_index];
+                    if (parent_index < 0)
+                    {
+                        globals[joint_index] = local;
+                    }
+                    else
+                    {
+                        compose(globals[parent_index], local, globals[joint_index]);
+                    }
+
+                    // Scatter the positions into the frames x joints x 3 layout
+                    for (int i = 0; i < num_frames; ++i)
+                    {
+                        Scalar* position = positions.data() + (batch_begin - frame_begin + i) * positions.rows();
+                        for (int row = 0; row < 3; ++row)
+                        {
+                            position[3 * joint_index + row] = globals[joint_index].translation[row](i);
+                        }
+                    }
+                }
+            }
+        }
+    } // namespace internal
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,265 @@
+#include "binary-format.hpp"
+#include "hierarchy-arena.hpp"
+#include "mapped-file.hpp"
+#include "parser.hpp"
+#include "statistics.hpp"
+#include <bvh11.hpp>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        inline void write_vector(BinaryWriter& writer, const Eigen::Vector3d& vector)
+        {
+            writer.Write(vector(0));
+            writer.Write(vector(1));
+            writer.Write(vector(2));
+        }
+
+        inline Eigen::Vector3d read_vector(BinaryReader& reader)
+        {
+            const double x = reader.Read<double>();
+            const double y = reader.Read<double>();
+            const double z = reader.Read<double>();
+            return Eigen::Vector3d(x, y, z);
+        }
+
+        /// \brief Read and validate the header.
+        /// \details A file of another format, of another version, or written with another byte order throws
+        ///          std::runtime_error instead of being misread as motion data.
+        /// \param file_size Size of the whole file, which must contain the hierarchy and the motion data.
+        inline BinaryHeader read_binary_header(const char* begin, const char* end, const std::uint64_t file_size)
+        {
+            BinaryReader       reader(begin, end);
+            const BinaryHeader header = reader.Read<BinaryHeader>();
+
+            if (std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0)
+            {
+                throw std::runtime_error("Not a bvh11 binary file.");
+            }
+            if (header.version != binary_version)
+            {
+                throw std::runtime_error("Unsupported binary format version " + std::to_string(header.version) + ".");
+            }
+            if (header.byte_order != binary_byte_order)
+            {
+                throw std::runtime_error("The binary file was written with a different byte order.");
+            }
+            if (header.num_joints <= 0 || header.num_channels < 0 || header.frames < 0 ||
+                header.motion_offset < sizeof(BinaryHeader))
+            {
+                throw std::runtime_error("Found an invalid binary header.");
+            }
+
+            const std::uint64_t motion_size = std::uint64_t(header.frames) * std::uint64_t(header.num_channels);
+            if (header.motion_offset > file_size || motion_size * sizeof(double) > file_size - header.motion_offset)
+            {
+                throw std::runtime_error("Found a truncated binary file.");
+            }
+
+            return header;
+        }
+
+        /// \brief Rebuild the hierarchy and the channels from the part between the header and the motion data.
+        inline void read_binary_hierarchy(BinaryReader&                          reader,
+                                          const BinaryHeader&                    header,
+                                          const double                           scale,
+                                          std::shared_ptr<const Joint>&          root_joint,
+                                          std::vector<Channel>&                  channels,
+                                          const std::shared_ptr<HierarchyArena>& arena)
+        {
+            // Joints are stored in the order of BvhObject::GetJointList, so parents always precede their children
+            std::vector<std::shared_ptr<Joint>> joints;
+            joints.reserve(header.num_joints);
+            for (int joint_index = 0; joint_index < header.num_joints; ++joint_index)
+            {
+                const std::int32_t parent_index = reader.Read<std::int32_t>();
+                const std::int32_t name_length  = reader.Read<std::int32_t>();
+                const std::uint8_t has_end_site = reader.Read<std::uint8_t>();
+
+                if (parent_index >= joint_index || name_length < 0 || (parent_index < 0) != (joint_index == 0))
+                {
+                    throw std::runtime_error("Found an invalid joint in the binary file.");
+                }
+
+                const std::shared_ptr<Joint> parent = (parent_index < 0) ? nullptr : joints[parent_index];
+                const std::shared_ptr<Joint> joint  = create_joint(reader.ReadString(name_length), parent, arena);
+
+                joint->offset()       = scale * read_vector(reader);
+                joint->end_site()     = scale * read_vector(reader);
+                joint->has_end_site() = (has_end_site != 0);
+
+                if (parent)
+                {
+                    parent->AddChild(joint);
+                }
+                else
+                {
+                    root_joint = joint;
+                }
+
+                joints.push_back(joint);
+            }
+
+            channels.reserve(header.num_channels);
+            for (int channel_index = 0; channel_index < header.num_channels; ++channel_index)
+            {
+                const std::uint8_t type        = reader.Read<std::uint8_t>();
+                const std::int32_t joint_index = reader.Read<std::int32_t>();
+
+                if (type > static_cast<std::uint8_t>(Channel::Type::y_rotation) || joint_index < 0 ||
+                    joint_index >= header.num_joints)
+                {
+                    throw std::runtime_error("Found an invalid channel in the binary file.");
+                }
+
+                channels.push_back(Channel{static_cast<Channel::Type>(type), joints[joint_index]});
+                joints[joint_index]->AssociateChannel(channel_index);
+            }
+        }
+    } // namespace internal
+
+    void BvhObject::WriteBinaryFile(const std::string& file_path) const
+    {
+        const std::vector<std::shared_ptr<const Joint>> joints = GetJointList();
+
+        internal::BinaryHeader header;
+        std::memcpy(header.magic, internal::binary_magic, sizeof(internal::binary_magic));
+        header.version       = internal::binary_version;
+        header.byte_order    = internal::binary_byte_order;
+        header.num_joints    = static_cast<std::int32_t>(joints.size());
+        header.num_channels  = static_cast<std::int32_t>(channels_.size());
+        header.frames        = static_cast<std::int32_t>(frames_);
+        header.reserved      = 0;
+        header.frame_time    = frame_time_;
+        header.motion_offset = 0;
+
+        internal::BinaryWriter writer;
+        writer.Write(header);
+
+        // Hierarchy
+        std::unordered_map<const Joint*, std::int32_t> joint_indices;
+        for (std::size_t i = 0; i < joints.size(); ++i)
+        {
+            joint_indices[joints[i].get()] = static_cast<std::int32_t>(i);
+        }
+        auto find_joint_index = [&](const Joint* joint) -> std::int32_t
+        {
+            const auto iterator = joint_indices.find(joint);
+            return (iterator != joint_indices.end()) ? iterator->second : -1;
+        };
+        for (const std::shared_ptr<const Joint>& joint : joints)
+        {
+            writer.Write(find_joint_index(joint->parent().get()));
+            writer.Write(static_cast<std::int32_t>(joint->name().size()));
+            writer.Write(static_cast<std::uint8_t>(joint->has_end_site()));
+            writer.WriteBytes(joint->name().data(), joint->name().size());
+            internal::write_vector(writer, joint->offset());
+            internal::write_vector(writer, joint->has_end_site() ? joint->end_site() : Eigen::Vector3d::Zero());
+        }
+
+        // Channels
+        for (const Channel& channel : channels_)
+        {
+            writer.Write(static_cast<std::uint8_t>(channel.type));
+            writer.Write(find_joint_index(channel.target_joint.get()));
+        }
+
+        // Align the motion data so that the whole block can be copied out of a memory mapping with aligned loads
+        writer.PadTo(internal::binary_motion_alignment);
+
+        header.motion_offset = writer.buffer().size();
+        std::memcpy(writer.buffer().data(), &header, sizeof(header));
+
+        // Open the output file
+        std::ofstream ofs(file_path, std::ios::binary);
+        assert(ofs.is_open() && "Failed to open the output file.");
+
+        ofs.write(writer.buffer().data(), writer.buffer().size());
+        ofs.write(reinterpret_cast<const char*>(motion_.data()), motion_.size() * sizeof(double));
+    }
+
+    void BvhObject::ReadBinaryFile(const std::string& file_path, const LoadOptions& options)
+    {
+        LoadStatistics*        statistics = internal::resolve_statistics(options.statistics);
+        internal::BinaryHeader header;
+
+        // Copy the motion block with a single memcpy from the mapping, or with a single read from a stream; motion_
+        // owns its values, so the block is copied once rather than aliased
+        internal::MappedFile mapped_file;
+        if (options.use_memory_mapping && mapped_file.Open(file_path))
+        {
+            const char* begin = mapped_file.data();
+            const char* end   = mapped_file.data() + mapped_file.size();
+
+            {
+                internal::ScopedTimer timer(statistics != nullptr ? &statistics->hierarchy_seconds : nullptr);
+
+                header = internal::read_binary_header(begin, end, mapped_file.size());
+
+                internal::BinaryReader reader(begin + sizeof(header), begin + header.motion_offset);
+                internal::read_binary_hierarchy(
+                    reader, header, options.scale, root_joint_, channels_, hierarchy_arena_);
+            }
+
+            internal::ScopedTimer timer(statistics != nullptr ? &statistics->motion_seconds : nullptr);
+            motion_ = Eigen::Map<const Eigen::MatrixXd>(
+                reinterpret_cast<const double*>(begin + header.motion_offset), header.frames, header.num_channels);
+        }
+        else
+        {
+            // Open the input file
+            std::ifstream ifs(file_path, std::ios::binary | std::ios::ate);
+            if (!ifs.is_open())
+            {
+                throw std::runtime_error("Failed to open the input file.");
+            }
+            const std::uint64_t file_size = static_cast<std::uint64_t>(ifs.tellg());
+            ifs.seekg(0);
+
+            {
+                internal::ScopedTimer timer(statistics != nullptr ? &statistics->hierarchy_seconds : nullptr);
+
+                std::vector<char> buffer(sizeof(header));
+                ifs.read(buffer.data(), buffer.size());
+                header = internal::read_binary_header(buffer.data(), buffer.data() + ifs.gcount(), file_size);
+
+                buffer.resize(header.motion_offset - sizeof(header));
+                ifs.read(buffer.data(), buffer.size());
+
+                internal::BinaryReader reader(buffer.data(), buffer.data() + ifs.gcount());
+                internal::read_binary_hierarchy(
+                    reader, header, options.scale, root_joint_, channels_, hierarchy_arena_);
+            }
+
+            internal::ScopedTimer timer(statistics != nullptr ? &statistics->motion_seconds : nullptr);
+            motion_.resize(header.frames, header.num_channels);
+            ifs.read(reinterpret_cast<char*>(motion_.data()), motion_.size() * sizeof(double));
+            if (ifs.gcount() != static_cast<std::streamsize>(motion_.size() * sizeof(double)))
+            {
+                throw std::runtime_error("Found a truncated binary file.");
+            }
+        }
+
+        frames_     = header.frames;
+        frame_time_ = header.frame_time;
+
+        if (statistics != nullptr)
+        {
+            statistics->num_bytes += header.motion_offset + motion_.size() * sizeof(double);
+        }
+
+        // Scale translations
+        if (options.scale != 1.0)
+        {
+            internal::ScopedTimer timer(statistics != nullptr ? &statistics->scaling_seconds : nullptr);
+            internal::scale_translations(channels_, options.scale, motion_);
+        }
+    }
+} // namespace bvh11
@@ -0,0 +1,123 @@
+#ifndef BVH11_BINARY_FORMAT_HPP_
+#define BVH11_BINARY_FORMAT_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        constexpr char          binary_magic[8]         = {'B', 'V', 'H', '1', '1', 'B', 'I', 'N'};
+        constexpr std::uint32_t binary_version          = 1;
+        constexpr std::uint32_t binary_byte_order       = 0x01020304;
+        constexpr std::size_t   binary_motion_alignment = 64;
+
+        /// \brief Fixed-size part at the beginning of a binary file.
+        struct BinaryHeader
+        {
+            char          magic[8];
+            std::uint32_t version;
+            std::uint32_t byte_order;
+            std::int32_t  num_joints;
+            std::int32_t  num_channels;
+            std::int32_t  frames;
+            std::int32_t  reserved;
+            double        frame_time;
+            std::uint64_t motion_offset;
+        };
+
+        /// \brief Writer that appends plain values to a byte buffer.
+        class BinaryWriter
+        {
+        public:
+            template <typename T>
+            void Write(const T& value)
+            {
+                const char* bytes = reinterpret_cast<const char*>(&value);
+                buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+            }
+
+            void WriteBytes(const char* bytes, std::size_t size) { buffer_.insert(buffer_.end(), bytes, bytes + size); }
+
+            void PadTo(std::size_t alignment)
+            {
+                buffer_.resize((buffer_.size() + alignment - 1) / alignment * alignment);
+            }
+
+            std::vector<char>& buffer() { return buffer_; }
+
+        private:
+            std::vector<char> buffer_;
+        };
+
+        /// \brief Reader that extracts plain values from a byte range.
+        /// \details Reading beyond the range throws std::runtime_error, so a truncated or corrupted file never makes
+        ///          the reader access memory outside of the range.
+        class BinaryReader
+        {
+        public:
+            BinaryReader(const char* begin, const char* end) : begin_(begin), cursor_(begin), end_(end) {}
+
+            template <typename T>
+            T Read()
+            {
+                Require(sizeof(T));
+
+                T value;
+                std::memcpy(&value, cursor_, sizeof(T));
+                cursor_ += sizeof(T);
+                return value;
+            }
+
+            std::string ReadString(std::size_t size)
+            {
+                Require(size);
+
+                const std::string value(cursor_, cursor_ + size);
+                cursor_ += size;
+                return value;
+            }
+
+            void ReadBytes(char* bytes, std::size_t size)
+            {
+                Require(size);
+
+                std::memcpy(bytes, cursor_, size);
+                cursor_ += size;
+            }
+
+            /// \return The number of the bytes that have not been read yet.
+            std::size_t remaining() const { return static_cast<std::size_t>(end_ - cursor_); }
+
+            /// \brief Skip the padding written by BinaryWriter::PadTo.
+            /// \details The cursor stops at the end of the range, so that the next read reports the truncation.
+            void SkipTo(std::size_t alignment)
+            {
+                const std::size_t position = cursor_ - begin_;
+                const std::size_t aligned  = (position + alignment - 1) / alignment * alignment;
+                cursor_                    = begin_ + std::min(aligned, static_cast<std::size_t>(end_ - begin_));
+            }
+
+        private:
+            const char* begin_;
+            const char* cursor_;
+            const char* end_;
+
+            void Require(std::size_t size) const
+            {
+                if (size > static_cast<std::size_t>(end_ - cursor_))
+                {
+                    throw std::runtime_error("Found a truncated binary file.");
+                }
+            }
+        };
+    } // namespace internal
+} // namespace bvh11
+
+#endif
@@ -1,142 +1,159 @@
+#include "batch-kinematics.hpp"
+#include "formatter.hpp"
+#include "hierarchy-arena.hpp"
+#include "mapped-file.hpp"
+#include "parser.hpp"
+#include "statistics.hpp"
 #include <bvh11.hpp>
+#include <algorithm>
+#include <bvh11/skeleton.hpp>
 #include <cassert>
 #include <fstream>
-#include <regex>
+#include <functional>
+#include <stdexcept>
 
 namespace bvh11
 {
     namespace internal
     {
-        inline std::vector<std::string> split(const std::string& sequence, const std::string& pattern)
+        /// \brief Compute the transformation of a joint relative to its parent channel by channel.
+        /// \details This is for joints that do not belong to the object (e.g., a joint of another object with the
+        ///          same hierarchy), whose channel indices are interpreted in the channels and the motion of the
+        ///          object.
+        inline Eigen::Affine3d compute_foreign_local_transform(const Joint&                joint,
+                                                               const std::vector<Channel>& channels,
+                                                               const Eigen::MatrixXd&      motion,
+                                                               int                         frame)
         {
-            const std::regex                 regex(pattern);
-            const std::sregex_token_iterator first{sequence.begin(), sequence.end(), regex, -1};
-            const std::sregex_token_iterator last{};
-            return std::vector<std::string>{first->str().empty() ? std::next(first) : first, last};
-        }
-
-        inline std::vector<std::string> tokenize_next_line(std::ifstream& ifs)
-        {
-            std::string line;
-            if (std::getline(ifs, line))
-            {
-                return internal::split(line, R"([\t\s]+)");
-            }
-            else
+            for (const int channel_index : joint.associated_channels_indices())
             {
-                assert(false && "Failed to read the next line");
-                return {};
+                if (channel_index < 0 || channel_index >= static_cast<int>(channels.size()))
+                {
+                    throw std::invalid_argument("The joint does not match the channels of this object.");
+                }
             }
-        }
 
-        inline Eigen::Vector3d read_offset(const std::vector<std::string>& tokens)
-        {
-            assert(tokens.size() == 4 && tokens[0] == "OFFSET");
-            const double offset_x = std::stod(tokens[1]);
-            const double offset_y = std::stod(tokens[2]);
-            const double offset_z = std::stod(tokens[3]);
-            return Eigen::Vector3d(offset_x, offset_y, offset_z);
-        }
-    } // namespace internal
-
-    std::vector<std::shared_ptr<const Joint>> BvhObject::GetJointList() const
-    {
-        std::vector<std::shared_ptr<const Joint>>         joint_list;
-        std::function<void(std::shared_ptr<const Joint>)> add_joint = [&](std::shared_ptr<const Joint> joint)
-        {
-            joint_list.push_back(joint);
-            for (auto child : joint->children())
+            // A joint with translation channels replaces its offset by them
+            Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+            if (joint.associated_channels_indices().size() != 6)
             {
-                add_joint(child);
+                transform *= Eigen::Translation3d(joint.offset());
             }
-        };
-        add_joint(root_joint_);
-        return joint_list;
-    }
-
-    Eigen::Affine3d BvhObject::GetTransformationRelativeToParent(std::shared_ptr<const Joint> joint, int frame) const
-    {
-        assert(frame < frames() && "Invalid frame is specified.");
-        assert(joint->associated_channels_indices().size() == 3 || joint->associated_channels_indices().size() == 6);
-
-        Eigen::Affine3d transform = Eigen::Affine3d::Identity();
 
-        const bool has_time_varying_translation = (joint->associated_channels_indices().size() == 6);
-
-        if (has_time_varying_translation)
-        {
-            // Apply time-varying transformations
-            for (int channel_index : joint->associated_channels_indices())
+            for (const int channel_index : joint.associated_channels_indices())
             {
-                const bvh11::Channel& channel = channels()[channel_index];
-                const double          value   = motion()(frame, channel_index);
-
-                switch (channel.type)
+                const double value = motion(frame, channel_index);
+                switch (channels[channel_index].type)
                 {
-                    case bvh11::Channel::Type::x_position:
+                    case Channel::Type::x_position:
                         transform *= Eigen::Translation3d(Eigen::Vector3d(value, 0.0, 0.0));
                         break;
-                    case bvh11::Channel::Type::y_position:
+                    case Channel::Type::y_position:
                         transform *= Eigen::Translation3d(Eigen::Vector3d(0.0, value, 0.0));
                         break;
-                    case bvh11::Channel::Type::z_position:
+                    case Channel::Type::z_position:
                         transform *= Eigen::Translation3d(Eigen::Vector3d(0.0, 0.0, value));
                         break;
-                    case bvh11::Channel::Type::x_rotation:
+                    case Channel::Type::x_rotation:
                         transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitX());
                         break;
-                    case bvh11::Channel::Type::y_rotation:
+                    case Channel::Type::y_rotation:
                         transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitY());
                         break;
-                    case bvh11::Channel::Type::z_rotation:
+                    case Channel::Type::z_rotation:
                         transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitZ());
                         break;
                 }
             }
+
+            return transform;
         }
-        else
+    } // namespace internal
+
+    int BvhObject::FindJointIndex(const Joint* joint) const
+    {
+        const auto iterator = joint_indices_.find(joint);
+        return (iterator != joint_indices_.end()) ? iterator->second : -1;
+    }
+
+    int BvhObject::GetJointIndex(const std::shared_ptr<const Joint>& joint) const
+    {
+        const int joint_index = FindJointIndex(joint.get());
+        if (joint_index < 0)
         {
-            // Apply intrinsic offset translation
-            transform *= Eigen::Translation3d(joint->offset());
+            throw std::invalid_argument("The joint does not belong to this object.");
+        }
+        return joint_index;
+    }
 
-            // Apply time-varying transformations
-            for (int channel_index : joint->associated_channels_indices())
-            {
-                const bvh11::Channel& channel = channels()[channel_index];
-                const double          value   = motion()(frame, channel_index);
+    bool BvhObject::HasSameHierarchy(const BvhObject& other) const
+    {
+        return skeleton_ == other.skeleton_ || skeleton_->IsEquivalent(*other.skeleton_);
+    }
 
-                switch (channel.type)
-                {
-                    case bvh11::Channel::Type::x_position:
-                    case bvh11::Channel::Type::y_position:
-                    case bvh11::Channel::Type::z_position:
-                        assert(false && "Found an invalid channel configuration");
-                        break;
-                    case bvh11::Channel::Type::x_rotation:
-                        transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitX());
-                        break;
-                    case bvh11::Channel::Type::y_rotation:
-                        transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitY());
-                        break;
-                    case bvh11::Channel::Type::z_rotation:
-                        transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitZ());
-                        break;
-                }
-            }
+    void BvhObject::ShareHierarchy(const BvhObject& other)
+    {
+        assert(HasSameHierarchy(other) && "The hierarchies are different.");
+
+        // Channels are not assignable, so the list is replaced by swapping
+        std::vector<Channel>(other.channels_).swap(channels_);
+
+        root_joint_      = other.root_joint_;
+        joint_list_      = other.joint_list_;
+        joint_indices_   = other.joint_indices_;
+        parent_indices_  = other.parent_indices_;
+        skeleton_        = other.skeleton_;
+        hierarchy_arena_ = other.hierarchy_arena_;
+    }
+
+    Eigen::Affine3d BvhObject::GetTransformationRelativeToParent(std::shared_ptr<const Joint> joint, int frame) const
+    {
+        assert(frame < frames() && "Invalid frame is specified.");
+        assert(joint->associated_channels_indices().size() == 3 || joint->associated_channels_indices().size() == 6);
+
+        const internal::KinematicsRecorder recorder(1);
+
+        const int joint_index = FindJointIndex(joint.get());
+        if (joint_index < 0)
+        {
+            return internal::compute_foreign_local_transform(*joint, channels_, motion_, frame);
         }
 
-        return transform;
+        return ComputeLocalTransform(joint_index, frame);
     }
 
     Eigen::Affine3d BvhObject::GetTransformation(std::shared_ptr<const Joint> joint, int frame) const
     {
-        Eigen::Affine3d transform = GetTransformationRelativeToParent(joint, frame);
+        assert(frame < frames() && "Invalid frame is specified.");
+
+        internal::KinematicsRecorder recorder(1);
+
+        int joint_index = FindJointIndex(joint.get());
+        if (joint_index < 0)
+        {
+            // Follow the parents of the joint itself, which may lead back into the joints of this object
+            Eigen::Affine3d transform = internal::compute_foreign_local_transform(*joint, channels_, motion_, frame);
+            for (std::shared_ptr<const Joint> parent = joint->parent(); parent != nullptr; parent = parent->parent())
+            {
+                const int parent_index = FindJointIndex(parent.get());
+
+                transform = ((parent_index >= 0)
+                                 ? ComputeLocalTransform(parent_index, frame)
+                                 : internal::compute_foreign_local_transform(*parent, channels_, motion_, frame)) *
+                            transform;
+                recorder.AddLocalTransforms(1);
+            }
+            return transform;
+        }
+
+        Eigen::Affine3d transform = ComputeLocalTransform(joint_index, frame);
 
-        while (joint->parent().get() != nullptr)
+        while (parent_indices_[joint_index] >= 0)
         {
-            joint = joint->parent();
+            joint_index = parent_indices_[joint_index];
 
-            transform = GetTransformationRelativeToParent(joint, frame) * transform;
+            transform = ComputeLocalTransform(joint_index, frame) * transform;
+            recorder.AddLocalTransforms(1);
         }
 
         return transform;
@@ -144,294 +161,350 @@ namespace bvh11
 
     void BvhObject::ReadBvhFile(const std::string& file_path, const double scale)
     {
-        // Open the input file
-        std::ifstream ifs(file_path);
-        assert(ifs.is_open() && "Failed to open the input file.");
+        LoadOptions options;
+        options.scale = scale;
+
+        ReadBvhFile(file_path, options);
+    }
+
+    BvhObject::BvhObject(const BvhObject&    other,
+                         const char*         motion_begin,
+                         const char*         motion_end,
+                         const std::uint64_t first_line_number,
+                         const LoadOptions&  options)
+        : BvhObject(other, 0, 0.0)
+    {
+        LoadStatistics* statistics = internal::resolve_statistics(options.statistics);
+
+        internal::ScopedTimer timer(statistics != nullptr ? &statistics->total_seconds : nullptr);
+        const std::uint64_t   allocation_count = internal::get_thread_allocation_count();
+
+        internal::MemoryLineReader reader(motion_begin, motion_end, first_line_number);
+        ReadMotionSection(reader, options);
+
+        {
+            internal::ScopedTimer scaling_timer(statistics != nullptr ? &statistics->scaling_seconds : nullptr);
+            internal::scale_translations(channels_, options.scale, motion_);
+        }
+
+        if (statistics != nullptr)
+        {
+            statistics->num_files += 1;
+            statistics->num_bytes += static_cast<std::uint64_t>(motion_end - motion_begin);
+            statistics->num_allocations += internal::get_thread_allocation_count() - allocation_count;
+        }
+    }
+
+    template <typename LineReader>
+    void BvhObject::ReadSections(LineReader& reader, const LoadOptions& options)
+    {
+        LoadStatistics* statistics = internal::resolve_statistics(options.statistics);
 
         // Read the HIERARCHY part
-        [&]() -> void
         {
-            std::string                         line;
-            std::vector<std::shared_ptr<Joint>> stack;
-            while (std::getline(ifs, line))
+            internal::ScopedTimer timer(statistics != nullptr ? &statistics->hierarchy_seconds : nullptr);
+            internal::read_hierarchy(reader, options.scale, root_joint_, channels_, hierarchy_arena_);
+        }
+
+        ReadMotionSection(reader, options);
+    }
+
+    template <typename LineReader>
+    void BvhObject::ReadMotionSection(LineReader& reader, const LoadOptions& options)
+    {
+        LoadStatistics* statistics = internal::resolve_statistics(options.statistics);
+
+        // Read the MOTION part
+        {
+            internal::ScopedTimer timer(statistics != nullptr ? &statistics->motion_seconds : nullptr);
+            internal::read_motion_header(reader, frames_, frame_time_);
+            motion_.resize(frames_, channels_.size());
+            if (options.num_threads == 1)
+            {
+                internal::read_frames(reader, motion_);
+            }
+            else
             {
-                // Split the line into tokens
-                const std::vector<std::string> tokens = internal::split(line, R"([\t\s]+)");
+                internal::read_frames_parallel(reader, motion_, options.num_threads);
 
-                // Ignore empty lines
-                if (tokens.empty())
-                {
-                    continue;
-                }
-                // Ignore a declaration of hierarchy section
-                else if (tokens[0] == "HIERARCHY")
+                // The frame lines are parsed by local readers of the workers, so they are counted here
+                if (statistics != nullptr)
                 {
-                    continue;
+                    statistics->num_lines += frames_;
+                    statistics->num_tokens += static_cast<std::uint64_t>(frames_) * channels_.size();
                 }
-                // Start to create a new joint
-                else if (tokens[0] == "ROOT" || tokens[0] == "JOINT")
-                {
-                    assert(tokens.size() == 2 && "Failed to find a joint name");
+            }
+        }
 
-                    // Read the joint name
-                    const std::string& joint_name = tokens[1];
+        if (statistics != nullptr)
+        {
+            statistics->num_lines += reader.num_lines();
+            statistics->num_tokens += reader.num_tokens();
+        }
+    }
 
-                    // Get a pointer for the parent if this is not a root joint
-                    const std::shared_ptr<Joint> parent = stack.empty() ? nullptr : stack.back();
+    template <typename ReadFunction>
+    void BvhObject::Load(const LoadOptions& options, ReadFunction read)
+    {
+        LoadStatistics* statistics = internal::resolve_statistics(options.statistics);
 
-                    // Instantiate a new joint
-                    std::shared_ptr<Joint> new_joint = std::make_shared<Joint>(joint_name, parent);
+        internal::ScopedTimer timer(statistics != nullptr ? &statistics->total_seconds : nullptr);
+        const std::uint64_t   allocation_count = internal::get_thread_allocation_count();
 
-                    // Register it to the parent's children list
-                    if (parent)
-                    {
-                        parent->AddChild(new_joint);
-                    }
-                    else
-                    {
-                        root_joint_ = new_joint;
-                    }
+        hierarchy_arena_ =
+            (options.hierarchy_storage == HierarchyStorage::arena) ? std::make_shared<HierarchyArena>() : nullptr;
 
-                    // Add the new joint to the stack
-                    stack.push_back(new_joint);
+        read();
 
-                    // Read the next line, which should be "{"
-                    const std::vector<std::string> tokens_begin_block = internal::tokenize_next_line(ifs);
-                    assert(tokens_begin_block.size() == 1 && "Found two or more tokens");
-                    assert(tokens_begin_block[0] == "{" && "Could not find an expected '{'");
-                }
-                // Read an offset value
-                else if (tokens[0] == "OFFSET")
-                {
-                    assert(tokens.size() == 4);
-                    const std::shared_ptr<Joint> current_joint = stack.back();
-                    current_joint->offset()                    = scale * internal::read_offset(tokens);
-                }
-                // Read a channel list
-                else if (tokens[0] == "CHANNELS")
-                {
-                    assert(tokens.size() >= 2);
-                    const int num_channels = std::stoi(tokens[1]);
+        // Prepare the joint list and the parent indices used by the batch evaluation
+        {
+            internal::ScopedTimer flattening_timer(statistics != nullptr ? &statistics->flattening_seconds : nullptr);
+            FlattenHierarchy();
+        }
 
-                    assert(tokens.size() == num_channels + 2);
-                    for (int i = 0; i < num_channels; ++i)
-                    {
-                        const std::shared_ptr<Joint> target_joint = stack.back();
-                        const Channel::Type          type         = [](const std::string& channel_type)
-                        {
-                            if (channel_type == "Xposition")
-                            {
-                                return Channel::Type::x_position;
-                            }
-                            if (channel_type == "Yposition")
-                            {
-                                return Channel::Type::y_position;
-                            }
-                            if (channel_type == "Zposition")
-                            {
-                                return Channel::Type::z_position;
-                            }
-                            if (channel_type == "Zrotation")
-                            {
-                                return Channel::Type::z_rotation;
-                            }
-                            if (channel_type == "Xrotation")
-                            {
-                                return Channel::Type::x_rotation;
-                            }
-                            if (channel_type == "Yrotation")
-                            {
-                                return Channel::Type::y_rotation;
-                            }
-
-                            assert(false && "Could not find a valid channel type");
-                            return Channel::Type();
-                        }(tokens[i + 2]);
-
-                        channels_.push_back(Channel{type, target_joint});
-
-                        const int channel_index = static_cast<int>(channels_.size() - 1);
-                        target_joint->AssociateChannel(channel_index);
-                    }
-                }
-                // Read an end site
-                else if (tokens[0] == "End")
-                {
-                    assert(tokens.size() == 2 && tokens[1] == "Site");
+        if (statistics != nullptr)
+        {
+            statistics->num_files += 1;
+            statistics->num_allocations += internal::get_thread_allocation_count() - allocation_count;
+        }
+    }
 
-                    const std::shared_ptr<Joint> current_joint = stack.back();
-                    current_joint->has_end_site()              = true;
+    void BvhObject::ReadBvhFile(const std::string& file_path, const LoadOptions& options)
+    {
+        Load(options,
+             [&]() -> void
+             {
+                 if (options.format == FileFormat::binary)
+                 {
+                     ReadBinaryFile(file_path, options);
+                 }
+                 else
+                 {
+                     ReadTextFile(file_path, options);
+                 }
+             });
+    }
 
-                    // Read the next line, which should be "{"
-                    const std::vector<std::string> tokens_begin_block = internal::tokenize_next_line(ifs);
-                    assert(tokens_begin_block.size() == 1 && "Found two or more tokens");
-                    assert(tokens_begin_block[0] == "{" && "Could not find an expected '{'");
+    BvhObject::BvhObject(const char* text_begin, const char* text_end, const LoadOptions& options)
+    {
+        Load(options, [&]() -> void { ReadText(text_begin, text_end, options); });
+    }
 
-                    // Read the next line, which should state an offset
-                    const std::vector<std::string> tokens_offset = internal::tokenize_next_line(ifs);
-                    current_joint->end_site()                    = scale * internal::read_offset(tokens_offset);
+    void BvhObject::ReadTextFile(const std::string& file_path, const LoadOptions& options)
+    {
+        // Parse the mapped bytes directly if possible; otherwise, read the file through a stream
+        internal::MappedFile mapped_file;
+        if (options.use_memory_mapping && mapped_file.Open(file_path))
+        {
+            ReadText(mapped_file.data(), mapped_file.data() + mapped_file.size(), options);
+            return;
+        }
 
-                    // Read the next line, which should be "{"
-                    const std::vector<std::string> tokens_end_block = internal::tokenize_next_line(ifs);
-                    assert(tokens_end_block.size() == 1 && "Found two or more tokens");
-                    assert(tokens_end_block[0] == "}" && "Could not find an expected '}'");
-                }
-                // Finish to create a joint
-                else if (tokens[0] == "}")
-                {
-                    assert(!stack.empty());
-                    stack.pop_back();
-                }
-                // Stop this iteration and go to the motion section
-                else if (tokens[0] == "MOTION")
-                {
-                    return;
-                }
-            }
-            assert(false && "Could not find the MOTION part");
-        }();
+        LoadStatistics* statistics = internal::resolve_statistics(options.statistics);
 
-        // Read the MOTION part
-        [&]() -> void
+        // Open the input file
+        std::ifstream ifs(file_path);
+        if (!ifs.is_open())
         {
-            // Read the number of frames
-            const std::vector<std::string> tokens_frames = internal::tokenize_next_line(ifs);
-            assert(tokens_frames.size() == 2);
-            assert(tokens_frames[0] == "Frames:");
-            frames_ = std::stoi(tokens_frames[1]);
-
-            // Read the frame time
-            const std::vector<std::string> tokens_frame_time = internal::tokenize_next_line(ifs);
-            assert(tokens_frame_time.size() == 3);
-            assert(tokens_frame_time[0] == "Frame" && tokens_frame_time[1] == "Time:");
-            frame_time_ = std::stod(tokens_frame_time[2]);
-
-            // Allocate memory for storing motion data
-            motion_.resize(frames_, channels_.size());
+            throw std::runtime_error("Failed to open the input file.");
+        }
 
-            // Read each frame
-            for (int frame_index = 0; frame_index < frames_; ++frame_index)
-            {
-                const std::vector<std::string> tokens = internal::tokenize_next_line(ifs);
-                assert(tokens.size() == channels_.size() && "Found invalid motion data");
+        internal::StreamLineReader reader(ifs);
+        ReadSections(reader, options);
 
-                for (int channel_index = 0; channel_index < channels_.size(); ++channel_index)
-                {
-                    motion_(frame_index, channel_index) = std::stod(tokens[channel_index]);
-                }
+        if (statistics != nullptr)
+        {
+            ifs.clear();
+            ifs.seekg(0, std::ios::end);
+            statistics->num_bytes += static_cast<std::uint64_t>(ifs.tellg());
+        }
+
+        // Scale translations
+        internal::ScopedTimer timer(statistics != nullptr ? &statistics->scaling_seconds : nullptr);
+        internal::scale_translations(channels_, options.scale, motion_);
+    }
+
+    void BvhObject::ReadText(const char* text_begin, const char* text_end, const LoadOptions& options)
+    {
+        LoadStatistics* statistics = internal::resolve_statistics(options.statistics);
+
+        internal::MemoryLineReader reader(text_begin, text_end);
+        ReadSections(reader, options);
+
+        if (statistics != nullptr)
+        {
+            statistics->num_bytes += static_cast<std::uint64_t>(text_end - text_begin);
+        }
+
+        // Scale translations
+        internal::ScopedTimer timer(statistics != nullptr ? &statistics->scaling_seconds : nullptr);
+        internal::scale_translations(channels_, options.scale, motion_);
+    }
+
+    void BvhObject::FlattenHierarchy()
+    {
+        joint_list_.clear();
+        joint_indices_.clear();
+        parent_indices_.clear();
+
+        std::function<void(std::shared_ptr<const Joint>, int)> add_joint =
+            [&](std::shared_ptr<const Joint> joint, int parent_index)
+        {
+            const int joint_index = static_cast<int>(joint_list_.size());
+
+            // Children in an arena do not own the joints, so the list holds pointers that share the arena instead
+            if (hierarchy_arena_)
+            {
+                joint_list_.push_back(std::shared_ptr<const Joint>(hierarchy_arena_, joint.get()));
             }
+            else
+            {
+                joint_list_.push_back(joint);
+            }
+            joint_indices_[joint.get()] = joint_index;
+            parent_indices_.push_back(parent_index);
 
-            // Scale translations
-            for (int channel_index = 0; channel_index < channels_.size(); ++channel_index)
+            for (auto child : joint->children())
             {
-                const Channel::Type& type = channels_[channel_index].type;
-                if (type == Channel::Type::x_position || type == Channel::Type::y_position ||
-                    type == Channel::Type::z_position)
-                {
-                    motion_.col(channel_index) = scale * motion_.col(channel_index);
-                }
+                add_joint(child, joint_index);
             }
-        }();
+        };
+        add_joint(root_joint_, -1);
+
+        skeleton_ = std::make_shared<const Skeleton>(*this);
     }
 
-    void BvhObject::PrintJointSubHierarchy(std::shared_ptr<const Joint> joint, int depth) const
+    void BvhObject::ComputeGlobalTransforms(int frame, TransformList& transforms) const
     {
-        for (int i = 0; i < depth; ++i)
+        transforms.resize(parent_indices_.size());
+        ComputeGlobalTransforms(frame, transforms.data());
+    }
+
+    void BvhObject::ComputeGlobalTransforms(int frame, Eigen::Affine3d* transforms) const
+    {
+        assert(frame < frames() && "Invalid frame is specified.");
+
+        const internal::KinematicsRecorder recorder(parent_indices_.size());
+
+        // Without the rotation cache and the static joints, every local transformation is evaluated from the channels
+        if (!has_rotation_cache() && !has_constant_channel_analysis())
         {
-            std::cout << "  ";
+            skeleton_->ComputeGlobalTransforms(motion_, frame, transforms);
+            return;
         }
-        std::cout << joint->name() << std::endl;
 
-        for (auto child : joint->children())
+        for (int joint_index = 0; joint_index < static_cast<int>(parent_indices_.size()); ++joint_index)
         {
-            PrintJointSubHierarchy(child, depth + 1);
+            const int parent_index = parent_indices_[joint_index];
+            if (parent_index < 0)
+            {
+                transforms[joint_index] = ComputeLocalTransform(joint_index, frame);
+            }
+            else
+            {
+                transforms[joint_index] = transforms[parent_index] * ComputeLocalTransform(joint_index, frame);
+            }
         }
     }
 
-    void BvhObject::WriteJointSubHierarchy(std::ofstream& ofs, std::shared_ptr<const Joint> joint, int depth) const
+    Eigen::MatrixXd BvhObject::ComputeGlobalPositions(int frame_begin, int frame_end) const
     {
-        auto indent_creation = [](int depth) -> std::string
-        {
-            std::string tabs = "";
-            for (int i = 0; i < depth; ++i)
-            {
-                tabs += "\t";
-            }
-            return tabs;
-        };
+        const internal::KinematicsRecorder recorder(parent_indices_.size() * std::uint64_t(frame_end - frame_begin));
 
-        ofs << indent_creation(depth);
-        ofs << (joint->parent() == nullptr ? "ROOT" : "JOINT");
-        ofs << " " << joint->name() << "\n";
-
-        ofs << indent_creation(depth);
-        ofs << "{"
-            << "\n";
-
-        ofs << indent_creation(depth + 1);
-        ofs << "OFFSET"
-            << " ";
-        ofs << joint->offset()(0) << " " << joint->offset()(1) << " " << joint->offset()(2);
-        ofs << "\n";
-
-        const auto associated_channels_indices = joint->associated_channels_indices();
-        ofs << indent_creation(depth + 1);
-        ofs << "CHANNELS"
-            << " " << associated_channels_indices.size();
-        for (auto i : associated_channels_indices)
+        Eigen::MatrixXd positions;
+        if (has_constant_channel_analysis())
         {
-            ofs << " " << channels()[i].type;
+            internal::compute_global_positions(*skeleton_,
+                                               motion_,
+                                               frame_begin,
+                                               frame_end,
+                                               positions,
+                                               static_joint_flags_.data(),
+                                               static_local_transforms_.data());
         }
-        ofs << "\n";
+        else
+        {
+            skeleton_->ComputeGlobalPositions(motion_, frame_begin, frame_end, positions);
+        }
+        return positions;
+    }
 
-        if (joint->has_end_site())
+    void BvhObject::PrintJointSubHierarchy(std::shared_ptr<const Joint> joint, int depth) const
+    {
+        for (int i = 0; i < depth; ++i)
         {
-            ofs << indent_creation(depth + 1);
-            ofs << "End Site"
-                << "\n";
-            ofs << indent_creation(depth + 1);
-            ofs << "{"
-                << "\n";
-            ofs << indent_creation(depth + 2);
-            ofs << "OFFSET"
-                << " ";
-            ofs << joint->end_site()(0) << " " << joint->end_site()(1) << " " << joint->end_site()(2);
-            ofs << "\n";
-            ofs << indent_creation(depth + 1);
-            ofs << "}"
-                << "\n";
+            std::cout << "  ";
         }
+        std::cout << joint->name() << std::endl;
 
         for (auto child : joint->children())
         {
-            WriteJointSubHierarchy(ofs, child, depth + 1);
+            PrintJointSubHierarchy(child, depth + 1);
         }
-
-        ofs << indent_creation(depth);
-        ofs << "}"
-            << "\n";
     }
 
-    void BvhObject::WriteBvhFile(const std::string& file_path) const
+    void BvhObject::WriteBvhFile(const std::string& file_path, const WriteOptions& options) const
     {
-        // Eigen format
-        const Eigen::IOFormat motion_format(Eigen::StreamPrecision, Eigen::DontAlignCols, " ", "", "", "\n", "", "");
+        assert(options.decimal_places >= 0 && "Invalid number of decimal places is specified.");
 
-        // Open the input file
-        std::ofstream ofs(file_path);
+        // Open the output file
+        std::ofstream ofs(file_path, std::ios::binary);
         assert(ofs.is_open() && "Failed to open the output file.");
 
-        // Hierarch
-        ofs << "HIERARCHY"
-            << "\n";
-        WriteJointSubHierarchy(ofs, root_joint_, 0);
+        // Hierarchy
+        std::string header = "HIERARCHY\n";
+        internal::append_joint_sub_hierarchy(header, root_joint_, channels_, 0, options);
 
         // Motion
-        ofs << "MOTION"
-            << "\n";
-        ofs << "Frames: " << frames_ << "\n";
-        ofs << "Frame Time: " << frame_time_ << "\n";
-        ofs << motion_.format(motion_format);
+        header += "MOTION\n";
+        header += "Frames: " + std::to_string(frames_) + "\n";
+        header += "Frame Time: ";
+        internal::append_double(header, frame_time_, options);
+        header += '\n';
+
+        ofs.write(header.data(), header.size());
+
+        // Format chunks of frames into reusable buffers (in parallel if requested), and write the buffers in order
+        constexpr int frames_per_chunk      = 256;
+        constexpr int num_chunks_per_thread = 4;
+
+        const int num_workers  = internal::resolve_num_threads(options.num_threads);
+        const int num_chunks   = (frames_ + frames_per_chunk - 1) / frames_per_chunk;
+        const int num_buffers  = std::min(num_chunks, num_workers * num_chunks_per_thread);
+        const int num_channels = static_cast<int>(motion_.cols());
+
+        std::vector<std::string> buffers(num_buffers);
+        for (int round_begin = 0; round_begin < num_chunks; round_begin += num_buffers)
+        {
+            const int num_round_chunks = std::min(num_buffers, num_chunks - round_begin);
+
+            auto format_chunk = [&](const int buffer_index) -> void
+            {
+                std::string& buffer = buffers[buffer_index];
+                buffer.clear();
+
+                const int frame_begin = (round_begin + buffer_index) * frames_per_chunk;
+                const int frame_end   = std::min(frame_begin + frames_per_chunk, frames_);
+                for (int frame = frame_begin; frame < frame_end; ++frame)
+                {
+                    for (int channel_index = 0; channel_index < num_channels; ++channel_index)
+                    {
+                        if (channel_index != 0)
+                        {
+                            buffer += ' ';
+                        }
+                        internal::append_double(buffer, motion_(frame, channel_index), options);
+                    }
+                    buffer += '\n';
+                }
+            };
+            internal::parallel_for(num_round_chunks, num_workers, format_chunk);
+
+            for (int buffer_index = 0; buffer_index < num_round_chunks; ++buffer_index)
+            {
+                ofs.write(buffers[buffer_index].data(), buffers[buffer_index].size());
+            }
+        }
     }
 
     void BvhObject::ResizeFrames(int num_new_frames)
@@ -440,32 +513,14 @@ namespace bvh11
 
         motion_.conservativeResize(num_new_frames, Eigen::NoChange);
         frames_ = num_new_frames;
+
+        ClearRotationCache();
+        ClearConstantChannelAnalysis();
         return;
     }
 
     std::ostream& operator<<(std::ostream& os, const Channel::Type& type)
     {
-        switch (type)
-        {
-            case Channel::Type::x_position:
-                os << "Xposition";
-                break;
-            case Channel::Type::y_position:
-                os << "Yposition";
-                break;
-            case Channel::Type::z_position:
-                os << "Zposition";
-                break;
-            case Channel::Type::x_rotation:
-                os << "Xrotation";
-                break;
-            case Channel::Type::y_rotation:
-                os << "Yrotation";
-                break;
-            case Channel::Type::z_rotation:
-                os << "Zrotation";
-                break;
-        }
-        return os;
+        return os << internal::get_channel_name(type);
     }
 } // namespace bvh11
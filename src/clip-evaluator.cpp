@@ -0,0 +1,92 @@
+#include "parallel-for.hpp"
+#include "thread-pool.hpp"
+#include <algorithm>
+#include <bvh11/clip-evaluator.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace bvh11
+{
+    ClipEvaluator::ClipEvaluator(const BvhObject& bvh, const ClipEvaluationOptions& options)
+        : bvh_(bvh),
+          options_(options),
+          num_joints_(bvh.skeleton()->num_joints())
+    {
+        assert(options_.chunk_size > 0 && "Invalid chunk size is specified.");
+
+#ifdef _OPENMP
+        const bool uses_thread_pool = options_.policy == ExecutionPolicy::thread_pool;
+#else
+        const bool uses_thread_pool = options_.policy != ExecutionPolicy::sequential;
+#endif
+        if (uses_thread_pool && internal::resolve_num_threads(options_.num_threads) > 1)
+        {
+            thread_pool_ = std::make_shared<internal::ThreadPool>(options_.num_threads);
+        }
+    }
+
+    void ClipEvaluator::Evaluate(int frame_begin, int frame_end, Eigen::Affine3d* transforms) const
+    {
+        assert(0 <= frame_begin && frame_begin <= frame_end && frame_end <= bvh_.frames() && "Invalid frame range.");
+
+        const int num_frames = frame_end - frame_begin;
+        const int num_chunks = (num_frames + options_.chunk_size - 1) / options_.chunk_size;
+
+        // Each chunk writes a disjoint range of the output, so the chunks can be processed in any order
+        auto evaluate_chunk = [&](const int chunk_index) -> void
+        {
+            const int chunk_begin = frame_begin + chunk_index * options_.chunk_size;
+            const int chunk_end   = std::min(chunk_begin + options_.chunk_size, frame_end);
+            for (int frame = chunk_begin; frame < chunk_end; ++frame)
+            {
+                bvh_.ComputeGlobalTransforms(frame,
+                                             transforms + static_cast<std::size_t>(frame - frame_begin) * num_joints_);
+            }
+        };
+
+        switch (options_.policy)
+        {
+            case ExecutionPolicy::sequential:
+                for (int chunk_index = 0; chunk_index < num_chunks; ++chunk_index)
+                {
+                    evaluate_chunk(chunk_index);
+                }
+                break;
+            case ExecutionPolicy::openmp:
+#ifdef _OPENMP
+            {
+                const int num_threads = internal::resolve_num_threads(options_.num_threads);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+                for (int chunk_index = 0; chunk_index < num_chunks; ++chunk_index)
+                {
+                    evaluate_chunk(chunk_index);
+                }
+                break;
+            }
+#endif
+            case ExecutionPolicy::thread_pool:
+                if (thread_pool_)
+                {
+                    thread_pool_->Run(num_chunks, evaluate_chunk);
+                }
+                else
+                {
+                    for (int chunk_index = 0; chunk_index < num_chunks; ++chunk_index)
+                    {
+                        evaluate_chunk(chunk_index);
+                    }
+                }
+                break;
+        }
+    }
+
+    void ClipEvaluator::Evaluate(int frame_begin, int frame_end, TransformList& transforms) const
+    {
+        transforms.resize(static_cast<std::size_t>(frame_end - frame_begin) * num_joints_);
+        Evaluate(frame_begin, frame_end, transforms.data());
+    }
+} // namespace bvh11
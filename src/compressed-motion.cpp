@@ -0,0 +1,642 @@
+#include "rotation-kernels.hpp"
+#include <algorithm>
+#include <bvh11/compressed-motion.hpp>
+#include <bvh11/pose.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+#include <cmath>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Number of the frames in a block; key offsets within a block are stored in 8 bits.
+        constexpr int compression_block_size = 256;
+
+        constexpr double max_quantized_value = 65535.0;
+
+        /// \brief Largest magnitude of the three smallest components of a unit quaternion.
+        constexpr double smallest_three_range = 0.70710678118654752440;
+
+        constexpr double max_smallest_three_value = 32767.0;
+
+        inline std::uint16_t quantize(const double value, const double minimum, const double extent)
+        {
+            if (extent == 0.0)
+            {
+                return 0;
+            }
+            const double normalized = std::min(std::max((value - minimum) / extent, 0.0), 1.0);
+            return static_cast<std::uint16_t>(std::floor(normalized * max_quantized_value + 0.5));
+        }
+
+        inline double dequantize(const std::uint16_t value, const double minimum, const double extent)
+        {
+            return minimum + extent * (value / max_quantized_value);
+        }
+
+        /// \brief Encode a unit quaternion into 15 bits per each of its three smallest components, where the index of
+        ///        the largest component is stored in the top bits of the first two values.
+        inline void encode_smallest_three(Eigen::Quaterniond quaternion, std::uint16_t* output)
+        {
+            int largest_index = 0;
+            quaternion.coeffs().cwiseAbs().maxCoeff(&largest_index);
+
+            // Make the largest component positive so that it can be restored from the others
+            if (quaternion.coeffs()(largest_index) < 0.0)
+            {
+                quaternion.coeffs() = -quaternion.coeffs();
+            }
+
+            int k = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                if (i == largest_index)
+                {
+                    continue;
+                }
+                const double normalized =
+                    (quaternion.coeffs()(i) + smallest_three_range) / (2.0 * smallest_three_range);
+                const double clamped = std::min(std::max(normalized, 0.0), 1.0);
+
+                output[k++] = static_cast<std::uint16_t>(std::floor(clamped * max_smallest_three_value + 0.5));
+            }
+            output[0] |= static_cast<std::uint16_t>((largest_index & 1) << 15);
+            output[1] |= static_cast<std::uint16_t>((largest_index >> 1) << 15);
+        }
+
+        inline Eigen::Quaterniond decode_smallest_three(const std::uint16_t* input)
+        {
+            const int largest_index = (input[0] >> 15) | ((input[1] >> 15) << 1);
+
+            Eigen::Quaterniond quaternion;
+
+            double squared_norm = 0.0;
+            int    k            = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                if (i == largest_index)
+                {
+                    continue;
+                }
+                const double value = (input[k++] & 0x7fff) / max_smallest_three_value;
+                const double coeff = (2.0 * value - 1.0) * smallest_three_range;
+
+                quaternion.coeffs()(i) = coeff;
+                squared_norm += coeff * coeff;
+            }
+            quaternion.coeffs()(largest_index) = std::sqrt(std::max(0.0, 1.0 - squared_norm));
+
+            return quaternion;
+        }
+
+        /// \brief Normalized linear interpolation along the shorter arc.
+        inline Eigen::Quaterniond
+        interpolate_rotation(const Eigen::Quaterniond& rotation_0, const Eigen::Quaterniond& rotation_1, double weight)
+        {
+            const double sign = (rotation_0.dot(rotation_1) < 0.0) ? -1.0 : 1.0;
+
+            Eigen::Quaterniond rotation;
+            rotation.coeffs() = (1.0 - weight) * rotation_0.coeffs() + (sign * weight) * rotation_1.coeffs();
+            rotation.normalize();
+
+            return rotation;
+        }
+
+        inline double compute_rotation_angle(const Eigen::Quaterniond& rotation_0, const Eigen::Quaterniond& rotation_1)
+        {
+            return 2.0 * std::acos(std::min(1.0, std::abs(rotation_0.dot(rotation_1))));
+        }
+
+        /// \brief Find the keys around the frame and the interpolation weight between them.
+        template <typename Track>
+        inline void find_keys(const Track& track, const int frame, int& key_0, int& key_1, double& weight)
+        {
+            const int block = frame / compression_block_size;
+            const int local = frame - block * compression_block_size;
+
+            const std::uint8_t* offsets   = track.key_offsets.data();
+            const int           key_begin = track.block_key_begins[block];
+            const int           key_end   = track.block_key_begins[block + 1];
+
+            // The first key of a block is always at its beginning
+            key_0 = static_cast<int>(std::upper_bound(offsets + key_begin, offsets + key_end, local) - offsets) - 1;
+            if (offsets[key_0] == local)
+            {
+                key_1  = key_0;
+                weight = 0.0;
+                return;
+            }
+
+            // The segment after the last key of a block ends at the first key of the next block
+            key_1 = key_0 + 1;
+
+            const int offset_1 = (key_1 < key_end) ? offsets[key_1] : compression_block_size;
+            weight             = static_cast<double>(local - offsets[key_0]) / (offset_1 - offsets[key_0]);
+        }
+
+        /// \brief Select keys so that the linear interpolation between consecutive keys is within the tolerance.
+        /// \details Keys are added greedily: each segment is extended as long as all the frames inside are within the
+        ///          tolerance. Every block starts with a key, and the last frame is always a key.
+        /// \param is_segment_valid Function that returns whether the frames between two keys are within the tolerance.
+        /// \param add_key Function that appends the value of a frame to the keys.
+        template <typename Track, typename SegmentValidator, typename KeyAdder>
+        void fit_keys(const int frames, SegmentValidator is_segment_valid, KeyAdder add_key, Track& track)
+        {
+            const int num_blocks = (frames + compression_block_size - 1) / compression_block_size;
+            for (int block = 0; block < num_blocks; ++block)
+            {
+                const int block_begin = block * compression_block_size;
+                const int block_end   = block_begin + compression_block_size;
+                const int last_frame  = std::min(block_end, frames - 1);
+
+                track.block_key_begins.push_back(static_cast<std::uint32_t>(track.key_offsets.size()));
+
+                int key = block_begin;
+                track.key_offsets.push_back(0);
+                add_key(key);
+
+                while (key < last_frame)
+                {
+                    int next_key = key + 1;
+                    while (next_key < last_frame && is_segment_valid(key, next_key + 1))
+                    {
+                        ++next_key;
+                    }
+                    key = next_key;
+
+                    // A key at the end of the block belongs to the next block
+                    if (key < block_end)
+                    {
+                        track.key_offsets.push_back(static_cast<std::uint8_t>(key - block_begin));
+                        add_key(key);
+                    }
+                }
+            }
+            track.block_key_begins.push_back(static_cast<std::uint32_t>(track.key_offsets.size()));
+        }
+
+        /// \brief Compute the longest distance from each joint to the joints and the end sites below it.
+        inline std::vector<double> compute_reaches(const Skeleton& skeleton)
+        {
+            const int num_joints = skeleton.num_joints();
+
+            std::vector<double> reaches(num_joints, 0.0);
+            for (int joint_index = num_joints - 1; joint_index >= 0; --joint_index)
+            {
+                if (skeleton.has_end_sites()[joint_index])
+                {
+                    reaches[joint_index] = std::max(reaches[joint_index], skeleton.end_sites().col(joint_index).norm());
+                }
+
+                const int parent_index = skeleton.parent_indices()[joint_index];
+                if (parent_index >= 0)
+                {
+                    const double reach = skeleton.offsets().col(joint_index).norm() + reaches[joint_index];
+                    reaches[parent_index] = std::max(reaches[parent_index], reach);
+                }
+            }
+
+            // Rotations of joints without anything below them do not move any position, but they still need a
+            // reasonable tolerance; use the average bone length
+            const double total_length = skeleton.offsets().colwise().norm().sum();
+            const double average_length =
+                (num_joints > 1 && total_length > 0.0) ? total_length / (num_joints - 1) : 1.0;
+            for (double& reach : reaches)
+            {
+                reach = std::max(reach, average_length);
+            }
+
+            return reaches;
+        }
+
+        /// \return The maximum number of the joints from the root to a leaf.
+        inline int compute_max_depth(const Skeleton& skeleton)
+        {
+            std::vector<int> depths(skeleton.num_joints(), 1);
+
+            int max_depth = 0;
+            for (int joint_index = 0; joint_index < skeleton.num_joints(); ++joint_index)
+            {
+                const int parent_index = skeleton.parent_indices()[joint_index];
+                if (parent_index >= 0)
+                {
+                    depths[joint_index] = depths[parent_index] + 1;
+                }
+                max_depth = std::max(max_depth, depths[joint_index]);
+            }
+            return max_depth;
+        }
+
+        /// \brief Append the positions of the joints and the end sites to the array.
+        inline void compute_positions(const Skeleton&               skeleton,
+                                      const TransformList&          transforms,
+                                      std::vector<Eigen::Vector3d>& output)
+        {
+            output.clear();
+            for (int joint_index = 0; joint_index < skeleton.num_joints(); ++joint_index)
+            {
+                output.push_back(transforms[joint_index].translation());
+                if (skeleton.has_end_sites()[joint_index])
+                {
+                    output.push_back(transforms[joint_index] * Eigen::Vector3d(skeleton.end_sites().col(joint_index)));
+                }
+            }
+        }
+
+        inline bool is_rotation_channel(const Channel::Type type)
+        {
+            return type == Channel::Type::x_rotation || type == Channel::Type::y_rotation ||
+                   type == Channel::Type::z_rotation;
+        }
+    } // namespace internal
+
+    CompressedMotion::CompressedMotion(const BvhObject& bvh, const CompressionOptions& options)
+        : skeleton_(bvh.skeleton()),
+          frames_(bvh.frames()),
+          frame_time_(bvh.frame_time()),
+          num_channels_(static_cast<int>(bvh.motion().cols())),
+          max_measured_error_(0.0)
+    {
+        assert(options.max_position_error > 0.0 && "Invalid error bound is specified.");
+
+        const Skeleton&        skeleton   = *skeleton_;
+        const Eigen::MatrixXd& motion     = bvh.motion();
+        const int              num_joints = skeleton.num_joints();
+
+        // Distribute the error bound over the channels along the longest chain; an angular error of a joint moves the
+        // positions below it at most by the angle times the reach of the joint
+        const std::vector<double> reaches = internal::compute_reaches(skeleton);
+        const double share = options.max_position_error / (3.0 * (internal::compute_max_depth(skeleton) + 1));
+
+        std::vector<double> base_channel_tolerances(num_channels_);
+        std::vector<double> base_rotation_tolerances(num_joints);
+        for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+        {
+            const int channel_begin = skeleton.channel_starts()[joint_index];
+            const int channel_end   = channel_begin + skeleton.channel_counts()[joint_index];
+            for (int channel_index = channel_begin; channel_index < channel_end; ++channel_index)
+            {
+                base_channel_tolerances[channel_index] =
+                    internal::is_rotation_channel(skeleton.channel_types()[channel_index])
+                        ? share / reaches[joint_index] * 180.0 / M_PI
+                        : share;
+            }
+            base_rotation_tolerances[joint_index] = 3.0 * share / reaches[joint_index];
+        }
+
+        // Precompute the original rotations and positions
+        QuaternionList rotations(static_cast<std::size_t>(frames_) * num_joints);
+        for (int frame = 0; frame < frames_; ++frame)
+        {
+            for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+            {
+                rotations[static_cast<std::size_t>(frame) * num_joints + joint_index] =
+                    skeleton.ComputeLocalRotation(joint_index, motion.data() + frame, motion.rows());
+            }
+        }
+
+        std::vector<std::vector<Eigen::Vector3d>> original_positions(frames_);
+        TransformList                             transforms;
+        for (int frame = 0; frame < frames_; ++frame)
+        {
+            skeleton.ComputeGlobalTransforms(motion, frame, transforms);
+            internal::compute_positions(skeleton, transforms, original_positions[frame]);
+        }
+
+        // The tolerances above assume the worst case where all the errors add up, so start from looser tolerances
+        // and tighten them until the error measured by forward kinematics is within the bound
+        constexpr double initial_multiplier = 8.0;
+        constexpr double minimum_multiplier = 1.0 / 64.0;
+
+        std::vector<Eigen::Vector3d> positions;
+        Pose                         pose;
+        Eigen::VectorXd              values;
+        auto                         measure_error = [&]() -> double
+        {
+            double max_error = 0.0;
+            for (int frame = 0; frame < frames_; ++frame)
+            {
+                DecompressPose(frame, pose, values);
+                pose.ComputeGlobalTransforms(skeleton.parent_indices(), transforms);
+                internal::compute_positions(skeleton, transforms, positions);
+
+                for (std::size_t i = 0; i < positions.size(); ++i)
+                {
+                    max_error = std::max(max_error, (positions[i] - original_positions[frame][i]).norm());
+                }
+            }
+            return max_error;
+        };
+
+        std::vector<double> channel_tolerances(num_channels_);
+        std::vector<double> rotation_tolerances(num_joints);
+        for (double multiplier = initial_multiplier; multiplier >= minimum_multiplier; multiplier *= 0.5)
+        {
+            for (int channel_index = 0; channel_index < num_channels_; ++channel_index)
+            {
+                channel_tolerances[channel_index] = multiplier * base_channel_tolerances[channel_index];
+            }
+            for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+            {
+                rotation_tolerances[joint_index] = multiplier * base_rotation_tolerances[joint_index];
+            }
+
+            BuildTracks(motion, rotations, channel_tolerances, rotation_tolerances, options.use_quaternions);
+
+            max_measured_error_ = measure_error();
+            if (max_measured_error_ <= options.max_position_error)
+            {
+                break;
+            }
+        }
+
+        // Store all the channels raw if even the tightest tolerances do not meet the bound, rather than returning data
+        // that silently violates it
+        if (max_measured_error_ > options.max_position_error)
+        {
+            std::fill(channel_tolerances.begin(), channel_tolerances.end(), 0.0);
+            std::fill(rotation_tolerances.begin(), rotation_tolerances.end(), 0.0);
+
+            BuildTracks(motion, rotations, channel_tolerances, rotation_tolerances, options.use_quaternions);
+
+            max_measured_error_ = measure_error();
+        }
+    }
+
+    void CompressedMotion::BuildTracks(const Eigen::MatrixXd&     motion,
+                                       const QuaternionList&      rotations,
+                                       const std::vector<double>& channel_tolerances,
+                                       const std::vector<double>& rotation_tolerances,
+                                       bool                       use_quaternions)
+    {
+        const Skeleton& skeleton   = *skeleton_;
+        const int       num_joints = skeleton.num_joints();
+
+        tracks_.clear();
+        rotation_track_indices_.assign(num_joints, -1);
+
+        auto add_channel_track = [&](const int channel_index) -> void
+        {
+            const double* values = motion.data() + channel_index * motion.rows();
+
+            Track track;
+            track.index          = channel_index;
+            track.is_rotation    = false;
+            track.is_raw         = false;
+            track.minimum        = (frames_ > 0) ? *std::min_element(values, values + frames_) : 0.0;
+            track.extent         = (frames_ > 0) ? *std::max_element(values, values + frames_) - track.minimum : 0.0;
+            track.initial_angles = Eigen::Vector3d::Zero();
+
+            const double tolerance = channel_tolerances[channel_index];
+
+            std::vector<double> quantized_values(frames_);
+            double              max_quantization_error = 0.0;
+            for (int frame = 0; frame < frames_; ++frame)
+            {
+                quantized_values[frame] = internal::dequantize(
+                    internal::quantize(values[frame], track.minimum, track.extent), track.minimum, track.extent);
+
+                const double quantization_error = std::abs(quantized_values[frame] - values[frame]);
+                max_quantization_error          = std::max(max_quantization_error, quantization_error);
+            }
+
+            // Keys cannot be within the tolerance if the quantization alone exceeds it (e.g., for a long translation)
+            if (max_quantization_error > tolerance)
+            {
+                track.is_raw = true;
+                track.raw_values.assign(values, values + frames_);
+                tracks_.push_back(track);
+                return;
+            }
+
+            auto is_segment_valid = [&](const int key_0, const int key_1) -> bool
+            {
+                for (int frame = key_0; frame <= key_1; ++frame)
+                {
+                    const double weight = static_cast<double>(frame - key_0) / (key_1 - key_0);
+                    const double value  = (1.0 - weight) * quantized_values[key_0] + weight * quantized_values[key_1];
+                    if (std::abs(value - values[frame]) > tolerance)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            auto add_key = [&](const int frame) -> void
+            {
+                track.key_values.push_back(internal::quantize(values[frame], track.minimum, track.extent));
+            };
+            internal::fit_keys(frames_, is_segment_valid, add_key, track);
+
+            tracks_.push_back(track);
+        };
+
+        /// \return Whether the track has been added; otherwise, the rotation has to be stored in the channels.
+        auto add_rotation_track = [&](const int joint_index, const int rotation_start) -> bool
+        {
+            auto get_rotation = [&](const int frame) -> const Eigen::Quaterniond&
+            { return rotations[static_cast<std::size_t>(frame) * num_joints + joint_index]; };
+
+            Track track;
+            track.index          = joint_index;
+            track.is_rotation    = true;
+            track.is_raw         = false;
+            track.minimum        = 0.0;
+            track.extent         = 0.0;
+            track.initial_angles = (frames_ > 0) ? Eigen::Vector3d(motion.block<1, 3>(0, rotation_start).transpose())
+                                                 : Eigen::Vector3d::Zero();
+
+            const double tolerance = rotation_tolerances[joint_index];
+
+            std::vector<std::uint16_t> encoded_values(3 * frames_);
+            QuaternionList             quantized_rotations(frames_);
+            for (int frame = 0; frame < frames_; ++frame)
+            {
+                internal::encode_smallest_three(get_rotation(frame), encoded_values.data() + 3 * frame);
+                quantized_rotations[frame] = internal::decode_smallest_three(encoded_values.data() + 3 * frame);
+
+                if (internal::compute_rotation_angle(quantized_rotations[frame], get_rotation(frame)) > tolerance)
+                {
+                    return false;
+                }
+            }
+
+            auto is_segment_valid = [&](const int key_0, const int key_1) -> bool
+            {
+                for (int frame = key_0; frame <= key_1; ++frame)
+                {
+                    const double             weight   = static_cast<double>(frame - key_0) / (key_1 - key_0);
+                    const Eigen::Quaterniond rotation = internal::interpolate_rotation(
+                        quantized_rotations[key_0], quantized_rotations[key_1], weight);
+                    if (internal::compute_rotation_angle(rotation, get_rotation(frame)) > tolerance)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            auto add_key = [&](const int frame) -> void
+            {
+                track.key_values.insert(track.key_values.end(),
+                                        encoded_values.begin() + 3 * frame,
+                                        encoded_values.begin() + 3 * frame + 3);
+            };
+            internal::fit_keys(frames_, is_segment_valid, add_key, track);
+
+            rotation_track_indices_[joint_index] = static_cast<int>(tracks_.size());
+            tracks_.push_back(track);
+
+            return true;
+        };
+
+        for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+        {
+            const RotationOrder order         = skeleton.rotation_orders()[joint_index];
+            const int           channel_begin = skeleton.channel_starts()[joint_index];
+            const int           channel_end   = channel_begin + skeleton.channel_counts()[joint_index];
+
+            // Joints with the generic layout keep their rotations in the channels, and so do the joints whose rotations
+            // cannot be quantized within the tolerance
+            const bool has_rotation_track = use_quaternions && order != RotationOrder::none &&
+                                            order != RotationOrder::generic &&
+                                            add_rotation_track(joint_index, channel_end - 3);
+            const int  channel_track_end  = has_rotation_track ? channel_end - 3 : channel_end;
+
+            for (int channel_index = channel_begin; channel_index < channel_track_end; ++channel_index)
+            {
+                add_channel_track(channel_index);
+            }
+        }
+    }
+
+    double CompressedMotion::DecodeChannel(const Track& track, int frame) const
+    {
+        if (track.is_raw)
+        {
+            return track.raw_values[frame];
+        }
+
+        int    key_0;
+        int    key_1;
+        double weight;
+        internal::find_keys(track, frame, key_0, key_1, weight);
+
+        const double value_0 = internal::dequantize(track.key_values[key_0], track.minimum, track.extent);
+        if (key_0 == key_1)
+        {
+            return value_0;
+        }
+
+        const double value_1 = internal::dequantize(track.key_values[key_1], track.minimum, track.extent);
+        return (1.0 - weight) * value_0 + weight * value_1;
+    }
+
+    Eigen::Quaterniond CompressedMotion::DecodeRotation(const Track& track, int frame) const
+    {
+        int    key_0;
+        int    key_1;
+        double weight;
+        internal::find_keys(track, frame, key_0, key_1, weight);
+
+        const Eigen::Quaterniond rotation_0 = internal::decode_smallest_three(track.key_values.data() + 3 * key_0);
+        if (key_0 == key_1)
+        {
+            return rotation_0;
+        }
+
+        const Eigen::Quaterniond rotation_1 = internal::decode_smallest_three(track.key_values.data() + 3 * key_1);
+        return internal::interpolate_rotation(rotation_0, rotation_1, weight);
+    }
+
+    void CompressedMotion::DecompressFrame(int frame, Eigen::VectorXd& values) const
+    {
+        assert(0 <= frame && frame < frames_ && "Invalid frame is specified.");
+
+        const bool has_previous_values = (values.size() == num_channels_);
+
+        values.resize(num_channels_);
+        for (const Track& track : tracks_)
+        {
+            if (!track.is_rotation)
+            {
+                values(track.index) = DecodeChannel(track, frame);
+                continue;
+            }
+
+            // Convert the rotation back to the Euler angles of the channels that are the closest to the previous ones
+            const int           joint_index    = track.index;
+            const RotationOrder order          = skeleton_->rotation_orders()[joint_index];
+            const int*          axes           = internal::rotation_axes[static_cast<int>(order)];
+            const int           rotation_start = skeleton_->channel_starts()[joint_index] +
+                                                 (skeleton_->has_translation_channels()[joint_index] ? 3 : 0);
+
+            const Eigen::Vector3d reference =
+                has_previous_values ? Eigen::Vector3d(values.segment<3>(rotation_start)) : track.initial_angles;
+
+            values.segment<3>(rotation_start) = internal::compute_closest_euler_angles(
+                DecodeRotation(track, frame).toRotationMatrix(), axes, reference);
+        }
+    }
+
+    void CompressedMotion::DecompressPose(int frame, Pose& pose, Eigen::VectorXd& values) const
+    {
+        assert(0 <= frame && frame < frames_ && "Invalid frame is specified.");
+
+        const int num_joints = skeleton_->num_joints();
+        pose.rotations.resize(num_joints);
+        pose.translations.resize(num_joints);
+
+        // Decode the channel tracks; the rotation channels of the joints with rotation tracks are not read
+        values.resize(num_channels_);
+        for (const Track& track : tracks_)
+        {
+            if (!track.is_rotation)
+            {
+                values(track.index) = DecodeChannel(track, frame);
+            }
+        }
+
+        for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+        {
+            const int track_index = rotation_track_indices_[joint_index];
+
+            pose.rotations[joint_index]    = (track_index >= 0)
+                                                 ? DecodeRotation(tracks_[track_index], frame)
+                                                 : skeleton_->ComputeLocalRotation(joint_index, values.data());
+            pose.translations[joint_index] = skeleton_->ComputeLocalTranslation(joint_index, values.data());
+        }
+    }
+
+    Eigen::MatrixXd CompressedMotion::Decompress() const
+    {
+        Eigen::MatrixXd motion(frames_, num_channels_);
+        Eigen::VectorXd values;
+        for (int frame = 0; frame < frames_; ++frame)
+        {
+            DecompressFrame(frame, values);
+            motion.row(frame) = values.transpose();
+        }
+        return motion;
+    }
+
+    std::size_t CompressedMotion::compressed_size_bytes() const
+    {
+        std::size_t size = sizeof(CompressedMotion);
+        for (const Track& track : tracks_)
+        {
+            size += sizeof(Track);
+            size += track.block_key_begins.size() * sizeof(std::uint32_t);
+            size += track.key_offsets.size() * sizeof(std::uint8_t);
+            size += track.key_values.size() * sizeof(std::uint16_t);
+            size += track.raw_values.size() * sizeof(double);
+        }
+        return size;
+    }
+
+    int CompressedMotion::num_raw_channels() const
+    {
+        return static_cast<int>(
+            std::count_if(tracks_.begin(), tracks_.end(), [](const Track& track) -> bool { return track.is_raw; }));
+    }
+} // namespace bvh11
@@ -0,0 +1,69 @@
+#include <bvh11.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cmath>
+
+namespace bvh11
+{
+    void BvhObject::AnalyzeConstantChannels(double tolerance)
+    {
+        const int num_channels = static_cast<int>(channels_.size());
+        const int num_joints   = skeleton_->num_joints();
+
+        constant_channel_flags_.assign(num_channels, 0);
+        static_joint_flags_.assign(num_joints, 0);
+        static_local_transforms_.assign(num_joints, Eigen::Affine3d::Identity());
+
+        // Without frames, no value is known, so only the joints without channels are static
+        for (int channel_index = 0; channel_index < num_channels && frames_ > 0; ++channel_index)
+        {
+            // Each channel is a contiguous column, which is scanned until the first value that differs
+            const double* values    = motion_.data() + static_cast<Eigen::Index>(channel_index) * frames_;
+            bool          is_constant = true;
+            for (int frame = 1; frame < frames_ && is_constant; ++frame)
+            {
+                is_constant = std::abs(values[frame] - values[0]) <= tolerance;
+            }
+            constant_channel_flags_[channel_index] = is_constant;
+        }
+
+        for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+        {
+            const int channel_start = skeleton_->channel_starts()[joint_index];
+            const int channel_end   = channel_start + skeleton_->channel_counts()[joint_index];
+
+            bool is_static = (frames_ > 0) || (channel_start == channel_end);
+            for (int channel_index = channel_start; channel_index < channel_end && is_static; ++channel_index)
+            {
+                is_static = constant_channel_flags_[channel_index] != 0;
+            }
+            if (is_static)
+            {
+                static_joint_flags_[joint_index] = 1;
+                static_local_transforms_[joint_index] =
+                    skeleton_->ComputeLocalTransform(joint_index, motion_.data(), motion_.rows());
+            }
+        }
+    }
+
+    void BvhObject::ClearConstantChannelAnalysis()
+    {
+        constant_channel_flags_.clear();
+        static_joint_flags_.clear();
+        static_local_transforms_.clear();
+    }
+
+    std::size_t BvhObject::EstimateRedundantMotionBytes() const
+    {
+        if (frames_ == 0)
+        {
+            return 0;
+        }
+
+        std::size_t num_constant_channels = 0;
+        for (const std::uint8_t is_constant : constant_channel_flags_)
+        {
+            num_constant_channels += is_constant;
+        }
+        return sizeof(double) * num_constant_channels * (frames_ - 1);
+    }
+} // namespace bvh11
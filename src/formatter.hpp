@@ -0,0 +1,238 @@
+#ifndef BVH11_FORMATTER_HPP_
+#define BVH11_FORMATTER_HPP_
+
+#include <algorithm>
+#include <bvh11.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        inline const char* get_channel_name(const Channel::Type type)
+        {
+            switch (type)
+            {
+                case Channel::Type::x_position:
+                    return "Xposition";
+                case Channel::Type::y_position:
+                    return "Yposition";
+                case Channel::Type::z_position:
+                    return "Zposition";
+                case Channel::Type::x_rotation:
+                    return "Xrotation";
+                case Channel::Type::y_rotation:
+                    return "Yrotation";
+                case Channel::Type::z_rotation:
+                    return "Zrotation";
+            }
+            return "";
+        }
+
+        /// \brief Size of the character buffer that is large enough for any output of format_double.
+        constexpr int max_formatted_double_length = 64;
+
+        /// \brief Write significand * 10^(-num_decimals) in the plain decimal notation (e.g., "-0.005").
+        /// \return Number of the written characters.
+        inline int
+        format_decimal(std::uint64_t significand, int num_decimals, const bool is_negative, char* output)
+        {
+            char digits[24];
+            int  num_digits = 0;
+            do
+            {
+                digits[num_digits++] = static_cast<char>('0' + significand % 10);
+                significand /= 10;
+            } while (significand != 0);
+
+            int length = 0;
+            if (is_negative)
+            {
+                output[length++] = '-';
+            }
+
+            // Integer part
+            if (num_digits <= num_decimals)
+            {
+                output[length++] = '0';
+            }
+            for (int i = num_digits - 1; i >= num_decimals; --i)
+            {
+                output[length++] = digits[i];
+            }
+
+            // Fractional part
+            if (num_decimals > 0)
+            {
+                output[length++] = '.';
+                for (int i = num_decimals - 1; i >= 0; --i)
+                {
+                    output[length++] = (i < num_digits) ? digits[i] : '0';
+                }
+            }
+
+            return length;
+        }
+
+        /// \brief Write the shortest plain decimal representation that is read back to exactly the same value.
+        /// \details The number of decimals is increased until significand / 10^decimals, which is computed with a
+        ///          single correctly rounded division as in the fast path of parse_double, reproduces the value. Values
+        ///          that need more than 53 bits or 17 decimals in this form fall back to printf with increasing
+        ///          precision, which is verified with strtod.
+        inline int format_shortest(const double value, char* output)
+        {
+            static const double powers_of_ten[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17};
+
+            constexpr double max_exact_significand = 9007199254740992.0;
+            constexpr int    max_num_decimals      = 17;
+
+            const double magnitude = std::abs(value);
+            if (magnitude < max_exact_significand)
+            {
+                for (int num_decimals = 0; num_decimals <= max_num_decimals; ++num_decimals)
+                {
+                    const double scaled = magnitude * powers_of_ten[num_decimals];
+                    if (scaled >= max_exact_significand)
+                    {
+                        break;
+                    }
+
+                    const double significand = std::floor(scaled + 0.5);
+                    if (significand / powers_of_ten[num_decimals] == magnitude)
+                    {
+                        return format_decimal(static_cast<std::uint64_t>(significand),
+                                              num_decimals,
+                                              std::signbit(value),
+                                              output);
+                    }
+                }
+            }
+
+            int length = 0;
+            for (int precision = 15; precision <= 17; ++precision)
+            {
+                length = std::snprintf(output, max_formatted_double_length, "%.*g", precision, value);
+                if (std::strtod(output, nullptr) == value)
+                {
+                    break;
+                }
+            }
+            return length;
+        }
+
+        /// \brief Write the value rounded to the number of decimal places, omitting trailing zeros.
+        /// \details Values that cannot be rounded with 53-bit integers are written by format_shortest instead.
+        inline int format_fixed(const double value, const int decimal_places, char* output)
+        {
+            static const double powers_of_ten[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17};
+
+            constexpr double max_exact_significand = 9007199254740992.0;
+            constexpr int    max_decimal_places    = 17;
+
+            const double scaled = std::abs(value) * powers_of_ten[std::min(decimal_places, max_decimal_places)];
+            if (decimal_places > max_decimal_places || !(scaled < max_exact_significand))
+            {
+                // Rounding does not shorten such values, so write them exactly
+                return format_shortest(value, output);
+            }
+
+            std::uint64_t significand  = static_cast<std::uint64_t>(std::floor(scaled + 0.5));
+            int           num_decimals = decimal_places;
+            while (num_decimals > 0 && significand % 10 == 0)
+            {
+                significand /= 10;
+                --num_decimals;
+            }
+
+            return format_decimal(significand, num_decimals, value < 0.0 && significand != 0, output);
+        }
+
+        inline int format_double(const double value, const WriteOptions& options, char* output)
+        {
+            switch (options.number_format)
+            {
+                case NumberFormat::fixed:
+                    return format_fixed(value, options.decimal_places, output);
+                case NumberFormat::shortest_round_trip:
+                    return format_shortest(value, output);
+            }
+            return 0;
+        }
+
+        inline void append_double(std::string& buffer, const double value, const WriteOptions& options)
+        {
+            char output[max_formatted_double_length];
+            buffer.append(output, format_double(value, options, output));
+        }
+
+        /// \brief Append the lines of the joint and its descendants in the HIERARCHY section.
+        inline void append_joint_sub_hierarchy(std::string&                 buffer,
+                                               std::shared_ptr<const Joint> joint,
+                                               const std::vector<Channel>&  channels,
+                                               int                          depth,
+                                               const WriteOptions&          options)
+        {
+            auto append_offset = [&](const Eigen::Vector3d& offset) -> void
+            {
+                buffer += "OFFSET";
+                for (int i = 0; i < 3; ++i)
+                {
+                    buffer += ' ';
+                    append_double(buffer, offset(i), options);
+                }
+                buffer += '\n';
+            };
+
+            buffer.append(depth, '\t');
+            buffer += (joint->parent() == nullptr ? "ROOT" : "JOINT");
+            buffer += ' ';
+            buffer += joint->name();
+            buffer += '\n';
+
+            buffer.append(depth, '\t');
+            buffer += "{\n";
+
+            buffer.append(depth + 1, '\t');
+            append_offset(joint->offset());
+
+            const auto& associated_channels_indices = joint->associated_channels_indices();
+            buffer.append(depth + 1, '\t');
+            buffer += "CHANNELS ";
+            buffer += std::to_string(associated_channels_indices.size());
+            for (const int i : associated_channels_indices)
+            {
+                buffer += ' ';
+                buffer += get_channel_name(channels[i].type);
+            }
+            buffer += '\n';
+
+            if (joint->has_end_site())
+            {
+                buffer.append(depth + 1, '\t');
+                buffer += "End Site\n";
+                buffer.append(depth + 1, '\t');
+                buffer += "{\n";
+                buffer.append(depth + 2, '\t');
+                append_offset(joint->end_site());
+                buffer.append(depth + 1, '\t');
+                buffer += "}\n";
+            }
+
+            for (auto child : joint->children())
+            {
+                append_joint_sub_hierarchy(buffer, child, channels, depth + 1, options);
+            }
+
+            buffer.append(depth, '\t');
+            buffer += "}\n";
+        }
+    } // namespace internal
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,82 @@
+#include "hierarchy-arena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace bvh11
+{
+    HierarchyArena::~HierarchyArena()
+    {
+        // Joints in the arena refer to each other without ownership, so they can be destroyed in any order
+        for (JointEntry* entry = last_joint_; entry != nullptr;)
+        {
+            JointEntry* previous = entry->previous;
+            entry->~JointEntry();
+            entry = previous;
+        }
+
+        for (Block* block = last_block_; block != nullptr;)
+        {
+            Block* previous = block->previous;
+            ::operator delete(block);
+            block = previous;
+        }
+    }
+
+    void* HierarchyArena::Allocate(std::size_t size, std::size_t alignment)
+    {
+        auto align = [&](char* pointer) -> char*
+        {
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer);
+            return reinterpret_cast<char*>((address + alignment - 1) / alignment * alignment);
+        };
+
+        char* begin = (cursor_ != nullptr) ? align(cursor_) : nullptr;
+        if (begin == nullptr || begin + size > end_)
+        {
+            // Start a new block, which is large enough for this allocation; the blocks grow geometrically
+            const std::size_t block_size = std::max(next_block_size_, sizeof(Block) + alignment + size);
+            next_block_size_ *= 2;
+
+            Block* block    = static_cast<Block*>(::operator new(block_size));
+            block->previous = last_block_;
+            last_block_     = block;
+
+            cursor_ = reinterpret_cast<char*>(block) + sizeof(Block);
+            end_    = reinterpret_cast<char*>(block) + block_size;
+            begin   = align(cursor_);
+        }
+
+        cursor_ = begin + size;
+        return begin;
+    }
+
+    Joint* HierarchyArena::CreateJoint(const std::string& name, const std::shared_ptr<Joint>& parent)
+    {
+        void*       memory = Allocate(sizeof(JointEntry), alignof(JointEntry));
+        JointEntry* entry  = new (memory) JointEntry{Joint(name, parent, this), last_joint_};
+        last_joint_        = entry;
+
+        return &entry->joint;
+    }
+
+    void Joint::AddChild(std::shared_ptr<Joint> child)
+    {
+        // A joint in an arena refers to its children without ownership; otherwise, the arena would own itself
+        if (children_.get_allocator().arena() != nullptr)
+        {
+            children_.push_back(std::shared_ptr<Joint>(std::shared_ptr<Joint>(), child.get()));
+        }
+        else
+        {
+            children_.push_back(child);
+        }
+    }
+
+    namespace internal
+    {
+        void* allocate_from_hierarchy_arena(HierarchyArena* arena, std::size_t size, std::size_t alignment)
+        {
+            return arena->Allocate(size, alignment);
+        }
+    } // namespace internal
+} // namespace bvh11
@@ -0,0 +1,67 @@
+#ifndef BVH11_HIERARCHY_ARENA_HPP_
+#define BVH11_HIERARCHY_ARENA_HPP_
+
+#include <bvh11.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace bvh11
+{
+    /// \brief Monotonic memory of the joints of an object loaded with HierarchyStorage::arena.
+    /// \details Memory is taken from a chain of blocks by bumping a pointer, and it is never freed individually. The
+    ///          arena is owned by the pointers to its joints (through the aliasing constructor of std::shared_ptr), so
+    ///          it destroys the joints and frees the blocks when the last of them is released.
+    class HierarchyArena
+    {
+    public:
+        HierarchyArena() = default;
+        ~HierarchyArena();
+
+        HierarchyArena(const HierarchyArena&)            = delete;
+        HierarchyArena& operator=(const HierarchyArena&) = delete;
+
+        void* Allocate(std::size_t size, std::size_t alignment);
+
+        /// \brief Construct a joint in the arena; it is destroyed by the arena.
+        Joint* CreateJoint(const std::string& name, const std::shared_ptr<Joint>& parent);
+
+    private:
+        /// \brief Header at the beginning of each block.
+        struct Block
+        {
+            Block* previous;
+        };
+
+        /// \brief Joint linked to the previously created one so that the arena can destroy all of them.
+        struct JointEntry
+        {
+            Joint       joint;
+            JointEntry* previous;
+        };
+
+        char*       cursor_          = nullptr;
+        char*       end_             = nullptr;
+        Block*      last_block_      = nullptr;
+        JointEntry* last_joint_      = nullptr;
+        std::size_t next_block_size_ = 16 * 1024;
+    };
+
+    namespace internal
+    {
+        /// \brief Create a joint on the heap, or in the arena if it is not null.
+        /// \return The joint, which shares the ownership of the arena if it is in the arena.
+        inline std::shared_ptr<Joint> create_joint(const std::string&                     name,
+                                                   const std::shared_ptr<Joint>&          parent,
+                                                   const std::shared_ptr<HierarchyArena>& arena)
+        {
+            if (arena == nullptr)
+            {
+                return std::make_shared<Joint>(name, parent);
+            }
+            return std::shared_ptr<Joint>(arena, arena->CreateJoint(name, parent));
+        }
+    } // namespace internal
+} // namespace bvh11
+
+#endif
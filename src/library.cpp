@@ -0,0 +1,250 @@
+#include "binary-format.hpp"
+#include "mapped-file.hpp"
+#include "parallel-for.hpp"
+#include "parser.hpp"
+#include "statistics.hpp"
+#include <algorithm>
+#include <bvh11/library.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Check that the contents have the expected beginning.
+        /// \return An error message, or an empty string if the contents look loadable.
+        inline std::string check_contents(const char* begin, const char* end, const FileFormat format)
+        {
+            const std::ptrdiff_t size = end - begin;
+            if (size == 0)
+            {
+                return "The file is empty.";
+            }
+
+            if (format == FileFormat::binary)
+            {
+                if (size < static_cast<std::ptrdiff_t>(sizeof(BinaryHeader)) ||
+                    std::memcmp(begin, binary_magic, sizeof(binary_magic)) != 0)
+                {
+                    return "Not a bvh11 binary file.";
+                }
+                return "";
+            }
+
+            // Skip a UTF-8 byte order mark and leading white spaces
+            constexpr char byte_order_mark[] = "\xEF\xBB\xBF";
+            if (size >= 3 && std::memcmp(begin, byte_order_mark, 3) == 0)
+            {
+                begin += 3;
+            }
+            auto is_not_space = [](const char c) -> bool { return !std::isspace(static_cast<unsigned char>(c)); };
+            begin             = std::find_if(begin, end, is_not_space);
+
+            constexpr char keyword[] = "HIERARCHY";
+            if (end - begin < static_cast<std::ptrdiff_t>(sizeof(keyword) - 1) ||
+                std::memcmp(begin, keyword, sizeof(keyword) - 1) != 0)
+            {
+                return "Could not find the HIERARCHY section.";
+            }
+            return "";
+        }
+
+        /// \brief Check that the file can be read and has the expected beginning.
+        /// \return An error message, or an empty string if the file looks loadable.
+        inline std::string check_file(const std::string& file_path, const FileFormat format)
+        {
+            std::ifstream ifs(file_path, std::ios::binary);
+            if (!ifs.is_open())
+            {
+                return "Failed to open the file.";
+            }
+
+            char       buffer[256];
+            const auto size = ifs.read(buffer, sizeof(buffer)).gcount();
+            return check_contents(buffer, buffer + size, format);
+        }
+
+        /// \brief Find the end of the HIERARCHY section, i.e., the line after the "MOTION" line.
+        /// \param num_lines Output number of the lines up to and including the "MOTION" line.
+        /// \return The beginning of the MOTION section, or null if the "MOTION" line is not found.
+        inline const char* find_motion_section(const char* begin, const char* end, std::uint64_t& num_lines)
+        {
+            MemoryLineReader reader(begin, end);
+            Tokenizer        tokenizer(nullptr, nullptr);
+            while (reader.ReadLine(tokenizer))
+            {
+                if (tokenizer.Next() == "MOTION")
+                {
+                    num_lines = reader.line_number();
+                    return reader.ReadRemaining().first;
+                }
+            }
+            return nullptr;
+        }
+    } // namespace internal
+
+    BvhLibrary::BvhLibrary(const std::vector<std::string>& file_paths, const LoadOptions& options, int num_threads)
+        : file_paths_(file_paths),
+          clips_(file_paths.size()),
+          error_messages_(file_paths.size()),
+          hierarchy_indices_(file_paths.size(), -1)
+    {
+        const int num_files = size();
+
+        // Each file records its statistics separately, since a load must not share them with concurrent loads
+        LoadStatistics*             statistics = internal::resolve_statistics(options.statistics);
+        std::vector<LoadStatistics> file_statistics(statistics != nullptr ? num_files : 0);
+
+        // Clips loaded so far by their raw HIERARCHY text, whose hierarchies are shared by the later clips
+        std::unordered_map<std::string, std::shared_ptr<const BvhObject>> known_hierarchies;
+        std::mutex                                                        known_hierarchies_mutex;
+
+        auto find_known_hierarchy = [&](const std::string& hierarchy_text) -> std::shared_ptr<const BvhObject>
+        {
+            std::lock_guard<std::mutex> lock(known_hierarchies_mutex);
+
+            const auto iterator = known_hierarchies.find(hierarchy_text);
+            return iterator != known_hierarchies.end() ? iterator->second : nullptr;
+        };
+
+        // Load the files concurrently; each task writes only its own elements
+        std::vector<std::shared_ptr<BvhObject>> clips(num_files);
+        auto load_file = [&](const int index) -> void
+        {
+            LoadOptions file_options = options;
+            file_options.statistics  = statistics != nullptr ? &file_statistics[index] : nullptr;
+
+            if (options.format == FileFormat::binary)
+            {
+                error_messages_[index] = internal::check_file(file_paths_[index], options.format);
+                if (!error_messages_[index].empty())
+                {
+                    return;
+                }
+
+                try
+                {
+                    clips[index] = std::make_shared<BvhObject>(file_paths_[index], file_options);
+                }
+                catch (const std::exception& exception)
+                {
+                    error_messages_[index] = exception.what();
+                }
+                return;
+            }
+
+            // Get the whole text once, mapped if requested and possible, or read into memory otherwise; both the
+            // lookup of the hierarchy and the parse use these bytes
+            internal::MappedFile mapped_file;
+            std::vector<char>    buffer;
+            const char*          begin;
+            const char*          end;
+            if (options.use_memory_mapping && mapped_file.Open(file_paths_[index]))
+            {
+                begin = mapped_file.data();
+                end   = mapped_file.data() + mapped_file.size();
+            }
+            else
+            {
+                std::ifstream ifs(file_paths_[index], std::ios::binary | std::ios::ate);
+                if (!ifs.is_open())
+                {
+                    error_messages_[index] = "Failed to open the file.";
+                    return;
+                }
+
+                buffer.resize(static_cast<std::size_t>(ifs.tellg()));
+                ifs.seekg(0);
+                ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.resize(static_cast<std::size_t>(ifs.gcount()));
+
+                begin = buffer.data();
+                end   = buffer.data() + buffer.size();
+            }
+
+            error_messages_[index] = internal::check_contents(begin, end, options.format);
+            if (!error_messages_[index].empty())
+            {
+                return;
+            }
+
+            try
+            {
+                // A file whose HIERARCHY text is already known only needs its MOTION section parsed
+                std::uint64_t num_hierarchy_lines = 0;
+                const char*   motion_begin        = internal::find_motion_section(begin, end, num_hierarchy_lines);
+                std::string   hierarchy_text      = motion_begin != nullptr ? std::string(begin, motion_begin) : "";
+
+                const std::shared_ptr<const BvhObject> representative =
+                    motion_begin != nullptr ? find_known_hierarchy(hierarchy_text) : nullptr;
+                if (representative != nullptr)
+                {
+                    clips[index] = std::shared_ptr<BvhObject>(
+                        new BvhObject(*representative, motion_begin, end, num_hierarchy_lines, file_options));
+                    return;
+                }
+
+                clips[index] = std::shared_ptr<BvhObject>(new BvhObject(begin, end, file_options));
+
+                std::lock_guard<std::mutex> lock(known_hierarchies_mutex);
+                known_hierarchies.emplace(std::move(hierarchy_text), clips[index]);
+            }
+            catch (const std::exception& exception)
+            {
+                error_messages_[index] = exception.what();
+            }
+        };
+        internal::parallel_for(num_files, num_threads, load_file);
+
+        for (const LoadStatistics& each_statistics : file_statistics)
+        {
+            *statistics += each_statistics;
+        }
+
+        // Let the clips with the same hierarchy share it; this is done in the order of the files so that the indices
+        // of the hierarchies do not depend on the scheduling of the threads
+        std::vector<std::shared_ptr<const BvhObject>> representatives;
+        for (int index = 0; index < num_files; ++index)
+        {
+            const std::shared_ptr<BvhObject>& clip = clips[index];
+            if (clip == nullptr)
+            {
+                continue;
+            }
+
+            int hierarchy_index = 0;
+            while (hierarchy_index < num_hierarchies() && !clip->HasSameHierarchy(*representatives[hierarchy_index]))
+            {
+                ++hierarchy_index;
+            }
+
+            if (hierarchy_index == num_hierarchies())
+            {
+                representatives.push_back(clip);
+                skeletons_.push_back(clip->skeleton());
+            }
+            else
+            {
+                clip->ShareHierarchy(*representatives[hierarchy_index]);
+            }
+
+            hierarchy_indices_[index] = hierarchy_index;
+            clips_[index]             = clip;
+        }
+    }
+
+    int BvhLibrary::num_loaded_clips() const
+    {
+        return static_cast<int>(
+            std::count_if(clips_.begin(),
+                          clips_.end(),
+                          [](const std::shared_ptr<const BvhObject>& clip) -> bool { return clip != nullptr; }));
+    }
+} // namespace bvh11
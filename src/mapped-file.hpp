@@ -0,0 +1,102 @@
+#ifndef BVH11_MAPPED_FILE_HPP_
+#define BVH11_MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BVH11_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Read-only memory mapping of a whole file.
+        /// \details Mapping is only possible for non-empty regular files on POSIX systems. Callers are expected to
+        ///          fall back to stream-based reading when Open() returns false (e.g., for pipes).
+        class MappedFile
+        {
+        public:
+            MappedFile() = default;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            ~MappedFile() { Close(); }
+
+            /// \return Whether the file has been successfully mapped.
+            bool Open(const std::string& file_path)
+            {
+                Close();
+#ifdef BVH11_HAS_MMAP
+                // Check the file type before opening it, since opening a FIFO would consume its data
+                struct stat path_status;
+                if (::stat(file_path.c_str(), &path_status) != 0 || !S_ISREG(path_status.st_mode))
+                {
+                    return false;
+                }
+
+                const int file_descriptor = ::open(file_path.c_str(), O_RDONLY);
+                if (file_descriptor < 0)
+                {
+                    return false;
+                }
+
+                struct stat file_status;
+                if (::fstat(file_descriptor, &file_status) != 0 || !S_ISREG(file_status.st_mode) ||
+                    file_status.st_size <= 0)
+                {
+                    ::close(file_descriptor);
+                    return false;
+                }
+
+                const std::size_t size    = static_cast<std::size_t>(file_status.st_size);
+                void*             address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+
+                // The mapping remains valid after the descriptor is closed
+                ::close(file_descriptor);
+
+                if (address == MAP_FAILED)
+                {
+                    return false;
+                }
+
+                ::madvise(address, size, MADV_SEQUENTIAL);
+
+                data_ = static_cast<const char*>(address);
+                size_ = size;
+
+                return true;
+#else
+                static_cast<void>(file_path);
+                return false;
+#endif
+            }
+
+            void Close()
+            {
+#ifdef BVH11_HAS_MMAP
+                if (data_ != nullptr)
+                {
+                    ::munmap(const_cast<char*>(data_), size_);
+                }
+#endif
+                data_ = nullptr;
+                size_ = 0;
+            }
+
+            const char* data() const { return data_; }
+            std::size_t size() const { return size_; }
+
+        private:
+            const char* data_ = nullptr;
+            std::size_t size_ = 0;
+        };
+    } // namespace internal
+} // namespace bvh11
+
+#endif
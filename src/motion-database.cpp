@@ -0,0 +1,198 @@
+#include "parallel-for.hpp"
+#include "thread-pool.hpp"
+#include <algorithm>
+#include <bvh11/motion-database.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Number of the frames processed by a task of the feature computation and the search.
+        /// \details The distances of a chunk (8 KB) stay in the L1 cache while the feature columns stream through it.
+        constexpr int database_chunk_size = 1024;
+
+        /// \brief Number of the frames below which a search runs on the calling thread, since waking up the workers
+        ///        would cost more than the scan.
+        constexpr int database_min_parallel_frames = 16 * database_chunk_size;
+    } // namespace internal
+
+    MotionDatabase::MotionDatabase(const std::vector<std::shared_ptr<const BvhObject>>& clips)
+    {
+        assert(!clips.empty() && "No clip is specified.");
+
+        skeleton_ = clips.front()->skeleton();
+
+        clip_frame_begins_.push_back(0);
+        for (const std::shared_ptr<const BvhObject>& clip : clips)
+        {
+            assert(clip->HasSameHierarchy(*clips.front()) && "The clips have different hierarchies.");
+
+            clip_frame_begins_.push_back(clip_frame_begins_.back() + clip->frames());
+            frame_times_.push_back(clip->frame_time());
+        }
+
+        motion_.resize(clip_frame_begins_.back(), skeleton_->num_channels());
+        for (int clip_index = 0; clip_index < num_clips(); ++clip_index)
+        {
+            motion_.middleRows(clip_frame_begin(clip_index), clips[clip_index]->frames()) = clips[clip_index]->motion();
+        }
+    }
+
+    int MotionDatabase::GetClipIndex(int frame) const
+    {
+        assert(0 <= frame && frame < num_frames() && "Invalid frame is specified.");
+
+        const auto iterator = std::upper_bound(clip_frame_begins_.begin(), clip_frame_begins_.end(), frame);
+        return static_cast<int>(iterator - clip_frame_begins_.begin()) - 1;
+    }
+
+    void MotionDatabase::ComputeFeatures(const FeatureOptions& options)
+    {
+        const int num_selected_joints = static_cast<int>(options.joint_indices.size());
+        const int num_position_cols   = 3 * num_selected_joints;
+        const int chunk_size          = internal::database_chunk_size;
+        const int num_chunks          = (num_frames() + chunk_size - 1) / chunk_size;
+
+        features_.resize(num_frames(), options.include_velocities ? 2 * num_position_cols : num_position_cols);
+
+        // Positions of the selected joints, computed by batched forward kinematics chunk by chunk
+        auto compute_positions = [&](const int chunk_index) -> void
+        {
+            const int frame_begin = chunk_index * chunk_size;
+            const int frame_end   = std::min(frame_begin + chunk_size, num_frames());
+
+            Eigen::MatrixXd positions;
+            skeleton_->ComputeGlobalPositions(motion_, frame_begin, frame_end, positions);
+
+            for (int frame = frame_begin; frame < frame_end; ++frame)
+            {
+                const auto global_positions = positions.col(frame - frame_begin);
+
+                // The root joint has no parent, so its local transformation is also its global transformation
+                const Eigen::Affine3d root_inverse =
+                    options.use_root_space
+                        ? skeleton_->ComputeLocalTransform(0, motion_.data() + frame, motion_.rows()).inverse()
+                        : Eigen::Affine3d::Identity();
+
+                for (int i = 0; i < num_selected_joints; ++i)
+                {
+                    const int joint_index = options.joint_indices[i];
+                    assert(0 <= joint_index && joint_index < skeleton_->num_joints() && "Invalid joint is specified.");
+
+                    const Eigen::Vector3d position = root_inverse * global_positions.segment<3>(3 * joint_index);
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        features_(frame, 3 * i + axis) = position(axis);
+                    }
+                }
+            }
+        };
+        internal::parallel_for(num_chunks, options.num_threads, compute_positions);
+
+        if (!options.include_velocities)
+        {
+            return;
+        }
+
+        // Velocities by central differences inside each clip and one-sided differences at its ends
+        auto compute_velocities = [&](const int clip_index) -> void
+        {
+            const int clip_begin = clip_frame_begin(clip_index);
+            const int clip_end   = clip_frame_end(clip_index);
+            for (int frame = clip_begin; frame < clip_end; ++frame)
+            {
+                const int next = std::min(frame + 1, clip_end - 1);
+                const int prev = std::max(frame - 1, clip_begin);
+                if (next == prev)
+                {
+                    features_.row(frame).segment(num_position_cols, num_position_cols).setZero();
+                    continue;
+                }
+
+                const double scale = 1.0 / ((next - prev) * frame_times_[clip_index]);
+                for (int col = 0; col < num_position_cols; ++col)
+                {
+                    features_(frame, num_position_cols + col) = scale * (features_(next, col) - features_(prev, col));
+                }
+            }
+        };
+        internal::parallel_for(num_clips(), options.num_threads, compute_velocities);
+    }
+
+    NearestFrame MotionDatabase::FindNearestFrame(const Eigen::VectorXd& query,
+                                                  const Eigen::VectorXd& weights,
+                                                  int                    num_threads) const
+    {
+        assert(query.size() == num_features() && "The query does not match the features.");
+        assert((weights.size() == 0 || weights.size() == num_features()) && "The weights do not match the features.");
+
+        const int num_chunks = (num_frames() + internal::database_chunk_size - 1) / internal::database_chunk_size;
+
+        // Each chunk keeps its distances in a fixed-capacity array on the stack, so a query does not allocate
+        using ChunkArray = Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, internal::database_chunk_size, 1>;
+
+        NearestFrame nearest = {-1, std::numeric_limits<double>::infinity()};
+        std::mutex   nearest_mutex;
+
+        // Search the chunks independently, where the distances of a chunk are accumulated over contiguous columns
+        auto search_chunk = [&](const int chunk_index) -> void
+        {
+            const int frame_begin = chunk_index * internal::database_chunk_size;
+            const int size        = std::min(internal::database_chunk_size, num_frames() - frame_begin);
+
+            auto get_term = [&](const int feature_index)
+            {
+                const double weight = weights.size() == 0 ? 1.0 : weights(feature_index);
+                return weight * (features_.col(feature_index).segment(frame_begin, size).array() - query(feature_index))
+                                    .square();
+            };
+
+            // Accumulate four features per pass so that the distances are loaded and stored less often
+            ChunkArray squared_distances = ChunkArray::Zero(size);
+
+            int feature_index = 0;
+            for (; feature_index + 4 <= num_features(); feature_index += 4)
+            {
+                squared_distances += get_term(feature_index) + get_term(feature_index + 1) +
+                                     get_term(feature_index + 2) + get_term(feature_index + 3);
+            }
+            for (; feature_index < num_features(); ++feature_index)
+            {
+                squared_distances += get_term(feature_index);
+            }
+
+            Eigen::Index index;
+            const double squared_distance = squared_distances.minCoeff(&index);
+            const int    frame            = frame_begin + static_cast<int>(index);
+
+            // Ties are always resolved to the earliest frame, whatever the order of the chunks is
+            std::lock_guard<std::mutex> lock(nearest_mutex);
+            if (squared_distance < nearest.squared_distance ||
+                (squared_distance == nearest.squared_distance && frame < nearest.frame))
+            {
+                nearest = NearestFrame{frame, squared_distance};
+            }
+        };
+
+        // Small databases are searched on the calling thread, and the others on persistent workers
+        if (num_frames() < internal::database_min_parallel_frames || internal::resolve_num_threads(num_threads) == 1)
+        {
+            for (int chunk_index = 0; chunk_index < num_chunks; ++chunk_index)
+            {
+                search_chunk(chunk_index);
+            }
+        }
+        else
+        {
+            // Pass the lambda by reference so that wrapping it in std::function does not allocate either
+            internal::get_shared_thread_pool(num_threads).Run(num_chunks, std::ref(search_chunk));
+        }
+
+        return nearest;
+    }
+} // namespace bvh11
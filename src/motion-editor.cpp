@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <bvh11/motion-editor.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+
+namespace bvh11
+{
+    MotionEditor::MotionEditor(BvhObject& bvh)
+        : bvh_(bvh),
+          num_evaluated_joints_(0)
+    {
+        const std::vector<int>& parent_indices = bvh_.parent_indices();
+
+        // Joints are in depth-first order, so a subtree ends where the last of its descendants ends
+        subtree_ends_.resize(parent_indices.size());
+        for (int joint_index = static_cast<int>(parent_indices.size()) - 1; joint_index >= 0; --joint_index)
+        {
+            subtree_ends_[joint_index] = std::max(subtree_ends_[joint_index], joint_index + 1);
+
+            const int parent_index = parent_indices[joint_index];
+            if (parent_index >= 0)
+            {
+                subtree_ends_[parent_index] = std::max(subtree_ends_[parent_index], subtree_ends_[joint_index]);
+            }
+        }
+
+        for (const Channel& channel : bvh_.channels())
+        {
+            channel_joint_indices_.push_back(bvh_.GetJointIndex(channel.target_joint));
+        }
+
+        InvalidateAll();
+    }
+
+    void MotionEditor::SetChannelValue(int frame, int channel_index, double value)
+    {
+        assert(0 <= frame && frame < bvh_.frames() && "Invalid frame is specified.");
+
+        // Skip the invalidation if nothing changes
+        Eigen::MatrixXd& motion = bvh_.mutable_motion();
+        if (motion(frame, channel_index) == value)
+        {
+            return;
+        }
+        motion(frame, channel_index) = value;
+
+        const int joint_index = channel_joint_indices_[channel_index];
+
+        std::uint8_t* flags = dirty_flags_.data() + static_cast<std::size_t>(frame) * num_joints();
+        std::fill(flags + joint_index, flags + subtree_ends_[joint_index], std::uint8_t(1));
+
+        first_dirty_joints_[frame] = std::min(first_dirty_joints_[frame], joint_index);
+    }
+
+    void MotionEditor::ResizeFrames(int num_new_frames)
+    {
+        bvh_.ResizeFrames(num_new_frames);
+
+        // The cache is stored frame by frame, so the existing frames stay valid and new frames start dirty
+        transforms_.resize(static_cast<std::size_t>(num_new_frames) * num_joints());
+        dirty_flags_.resize(static_cast<std::size_t>(num_new_frames) * num_joints(), 1);
+        first_dirty_joints_.resize(num_new_frames, 0);
+    }
+
+    void MotionEditor::InvalidateAll()
+    {
+        const std::size_t size = static_cast<std::size_t>(bvh_.frames()) * num_joints();
+
+        transforms_.resize(size);
+        dirty_flags_.assign(size, 1);
+        first_dirty_joints_.assign(bvh_.frames(), 0);
+    }
+
+    const Eigen::Affine3d& MotionEditor::GetTransformation(int joint_index, int frame)
+    {
+        return GetTransformations(frame)[joint_index];
+    }
+
+    const Eigen::Affine3d* MotionEditor::GetTransformations(int frame)
+    {
+        assert(0 <= frame && frame < bvh_.frames() && "Invalid frame is specified.");
+
+        UpdateFrame(frame);
+        return transforms_.data() + static_cast<std::size_t>(frame) * num_joints();
+    }
+
+    void MotionEditor::UpdateFrame(int frame)
+    {
+        const int first_dirty_joint = first_dirty_joints_[frame];
+        if (first_dirty_joint == num_joints())
+        {
+            return;
+        }
+
+        const Skeleton&         skeleton       = *bvh_.skeleton();
+        const std::vector<int>& parent_indices = bvh_.parent_indices();
+        const Eigen::MatrixXd&  motion         = bvh_.motion();
+        const double*           values         = motion.data() + frame;
+        const Eigen::Index      stride         = motion.rows();
+
+        Eigen::Affine3d* transforms = transforms_.data() + static_cast<std::size_t>(frame) * num_joints();
+        std::uint8_t*    flags      = dirty_flags_.data() + static_cast<std::size_t>(frame) * num_joints();
+
+        // A dirty joint has a clean or already updated parent, since the parent precedes it and dirtiness is
+        // always propagated to the whole subtree
+        for (int joint_index = first_dirty_joint; joint_index < num_joints(); ++joint_index)
+        {
+            if (!flags[joint_index])
+            {
+                continue;
+            }
+
+            const int parent_index = parent_indices[joint_index];
+            if (parent_index < 0)
+            {
+                transforms[joint_index] = skeleton.ComputeLocalTransform(joint_index, values, stride);
+            }
+            else
+            {
+                transforms[joint_index] =
+                    transforms[parent_index] * skeleton.ComputeLocalTransform(joint_index, values, stride);
+            }
+
+            flags[joint_index] = 0;
+            ++num_evaluated_joints_;
+        }
+
+        first_dirty_joints_[frame] = num_joints();
+    }
+} // namespace bvh11
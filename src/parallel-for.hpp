@@ -0,0 +1,91 @@
+#ifndef BVH11_PARALLEL_FOR_HPP_
+#define BVH11_PARALLEL_FOR_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \return The number of worker threads to be used; zero is interpreted as all the hardware threads.
+        inline int resolve_num_threads(const int num_threads)
+        {
+            if (num_threads > 0)
+            {
+                return num_threads;
+            }
+            return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+
+        /// \brief Call the function for every task index in [0, num_tasks) using worker threads started for this call.
+        /// \details Workers repeatedly take the next unprocessed task index from a shared atomic counter, so tasks
+        ///          with uneven costs are balanced dynamically. The threads are joined before returning, so
+        ///          ThreadPool suits repeated short loops better. The calling thread also works as one of the workers.
+        ///          If a task throws an exception, the workers stop taking new tasks, and the first exception is
+        ///          rethrown on the calling thread after all the workers have finished.
+        template <typename Function>
+        void parallel_for(const int num_tasks, const int num_threads, Function function)
+        {
+            const int num_workers = std::min(resolve_num_threads(num_threads), num_tasks);
+            if (num_workers <= 1)
+            {
+                for (int task_index = 0; task_index < num_tasks; ++task_index)
+                {
+                    function(task_index);
+                }
+                return;
+            }
+
+            std::atomic<int>   next_task_index(0);
+            std::exception_ptr exception;
+            std::mutex         exception_mutex;
+
+            auto work = [&]() -> void
+            {
+                try
+                {
+                    for (int task_index = next_task_index++; task_index < num_tasks; task_index = next_task_index++)
+                    {
+                        function(task_index);
+                    }
+                }
+                catch (...)
+                {
+                    // Skip the remaining tasks, since the result is discarded anyway
+                    next_task_index = num_tasks;
+
+                    std::lock_guard<std::mutex> lock(exception_mutex);
+                    if (!exception)
+                    {
+                        exception = std::current_exception();
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(num_workers - 1);
+            for (int i = 0; i < num_workers - 1; ++i)
+            {
+                threads.emplace_back(work);
+            }
+            work();
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    } // namespace internal
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,821 @@
+#ifndef BVH11_PARSER_HPP_
+#define BVH11_PARSER_HPP_
+
+#include "hierarchy-arena.hpp"
+#include "parallel-for.hpp"
+#include "statistics.hpp"
+#include <bvh11.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        inline bool is_space(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+        }
+
+        inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+        /// \brief Report malformed input by throwing std::runtime_error whose message starts with the line number.
+        [[noreturn]] inline void throw_parse_error(const std::uint64_t line_number, const std::string& message)
+        {
+            throw std::runtime_error("Line " + std::to_string(line_number) + ": " + message);
+        }
+
+        /// \brief A non-owning view of a token (i.e., a range of characters in a line buffer).
+        /// \details This plays the role of std::string_view, which is not available in C++11.
+        struct Token
+        {
+            const char* begin = nullptr;
+            const char* end   = nullptr;
+
+            bool empty() const { return begin == end; }
+
+            std::size_t size() const { return static_cast<std::size_t>(end - begin); }
+
+            std::string str() const { return std::string(begin, end); }
+
+            bool operator==(const char* literal) const
+            {
+                const std::size_t length = std::strlen(literal);
+                return size() == length && std::memcmp(begin, literal, length) == 0;
+            }
+
+            bool operator!=(const char* literal) const { return !(*this == literal); }
+        };
+
+        /// \brief Single-pass, allocation-free tokenizer for a line of text.
+        class Tokenizer
+        {
+        public:
+            /// \param num_tokens Counter of the tokens for the statistics, or null.
+            /// \param line_number Number of the line (starting from one) reported by parse errors.
+            Tokenizer(const char*    begin,
+                      const char*    end,
+                      std::uint64_t* num_tokens  = nullptr,
+                      std::uint64_t  line_number = 0)
+                : cursor_(begin),
+                  end_(end),
+                  num_tokens_(num_tokens),
+                  line_number_(line_number)
+            {
+            }
+
+            /// \return The next whitespace-delimited token, or an empty token if the line has no more tokens.
+            Token Next()
+            {
+                SkipSpaces();
+
+                Token token;
+                token.begin = cursor_;
+                while (cursor_ != end_ && !is_space(*cursor_))
+                {
+                    ++cursor_;
+                }
+                token.end = cursor_;
+
+                if (is_statistics_enabled() && num_tokens_ != nullptr && !token.empty())
+                {
+                    ++(*num_tokens_);
+                }
+
+                return token;
+            }
+
+            /// \return Whether the line has no more tokens.
+            bool AtEnd()
+            {
+                SkipSpaces();
+                return cursor_ == end_;
+            }
+
+            /// \brief Parse the next token as a double-precision floating-point number.
+            double NextDouble();
+
+            /// \brief Parse the next token as an integer.
+            int NextInt();
+
+            /// \brief Throw a parse error at the line of this tokenizer.
+            [[noreturn]] void Fail(const std::string& message) const { throw_parse_error(line_number_, message); }
+
+            /// \brief Throw a parse error unless the line has no more tokens.
+            void ExpectEnd(const char* message)
+            {
+                if (!AtEnd())
+                {
+                    Fail(message);
+                }
+            }
+
+            std::uint64_t line_number() const { return line_number_; }
+
+        private:
+            const char*    cursor_;
+            const char*    end_;
+            std::uint64_t* num_tokens_;
+            std::uint64_t  line_number_;
+
+            void SkipSpaces()
+            {
+                while (cursor_ != end_ && is_space(*cursor_))
+                {
+                    ++cursor_;
+                }
+            }
+        };
+
+        /// \brief Parse a number with std::strtod, which requires a null-terminated string.
+        /// \return Whether the whole token is a valid number.
+        inline bool parse_double_slow(const Token& token, double& value)
+        {
+            char buffer[64];
+            if (token.size() < sizeof(buffer))
+            {
+                std::memcpy(buffer, token.begin, token.size());
+                buffer[token.size()] = '\0';
+
+                char* parse_end = nullptr;
+                value           = std::strtod(buffer, &parse_end);
+
+                return parse_end == buffer + token.size();
+            }
+            else
+            {
+                const std::string text      = token.str();
+                char*             parse_end = nullptr;
+                value                       = std::strtod(text.c_str(), &parse_end);
+
+                return parse_end == text.c_str() + text.size();
+            }
+        }
+
+        /// \brief Parse a decimal number without any heap allocation.
+        /// \details This uses Clinger's fast path: when the significand fits in 53 bits and the decimal exponent is
+        ///          small enough for the power of ten to be exactly representable, a single floating-point
+        ///          multiplication or division gives the correctly rounded result. Other inputs (e.g., very long
+        ///          significands, "inf", "nan") fall back to std::strtod, so the result is always the same as that
+        ///          of std::stod.
+        /// \return Whether the whole token is a valid number.
+        inline bool parse_double(const Token& token, double& value)
+        {
+            static const double powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+            constexpr std::uint64_t max_exact_significand = std::uint64_t(1) << 53;
+            constexpr int           max_significant_digits = 19;
+            constexpr int           max_exact_exponent     = 22;
+
+            const char* cursor = token.begin;
+            const char* end    = token.end;
+
+            const bool is_negative = (cursor != end && *cursor == '-');
+            if (cursor != end && (*cursor == '-' || *cursor == '+'))
+            {
+                ++cursor;
+            }
+
+            std::uint64_t significand        = 0;
+            int           significant_digits = 0;
+            int           exponent           = 0;
+            bool          has_digits         = false;
+
+            while (cursor != end && is_digit(*cursor))
+            {
+                if (significant_digits < max_significant_digits)
+                {
+                    significand = 10 * significand + static_cast<std::uint64_t>(*cursor - '0');
+                    significant_digits += (significand != 0);
+                }
+                else
+                {
+                    // Digits beyond the capacity are only reflected in the exponent; it is not exact anymore
+                    significant_digits = max_significant_digits + 1;
+                    ++exponent;
+                }
+                has_digits = true;
+                ++cursor;
+            }
+            if (cursor != end && *cursor == '.')
+            {
+                ++cursor;
+                while (cursor != end && is_digit(*cursor))
+                {
+                    if (significant_digits < max_significant_digits)
+                    {
+                        significand = 10 * significand + static_cast<std::uint64_t>(*cursor - '0');
+                        significant_digits += (significand != 0);
+                        --exponent;
+                    }
+                    else
+                    {
+                        significant_digits = max_significant_digits + 1;
+                    }
+                    has_digits = true;
+                    ++cursor;
+                }
+            }
+            if (has_digits && cursor != end && (*cursor == 'e' || *cursor == 'E'))
+            {
+                ++cursor;
+                const bool is_exponent_negative = (cursor != end && *cursor == '-');
+                if (cursor != end && (*cursor == '-' || *cursor == '+'))
+                {
+                    ++cursor;
+                }
+                int explicit_exponent = 0;
+                while (cursor != end && is_digit(*cursor))
+                {
+                    if (explicit_exponent < 100000)
+                    {
+                        explicit_exponent = 10 * explicit_exponent + (*cursor - '0');
+                    }
+                    ++cursor;
+                }
+                exponent += is_exponent_negative ? -explicit_exponent : explicit_exponent;
+            }
+
+            const bool is_fast_path = has_digits && cursor == end && significant_digits <= max_significant_digits &&
+                                      significand <= max_exact_significand && exponent >= -max_exact_exponent &&
+                                      exponent <= max_exact_exponent;
+            if (!is_fast_path)
+            {
+                return parse_double_slow(token, value);
+            }
+
+            value = static_cast<double>(significand);
+            value = (exponent < 0) ? value / powers_of_ten[-exponent] : value * powers_of_ten[exponent];
+            value = is_negative ? -value : value;
+
+            return true;
+        }
+
+        /// \return Whether the whole token is a valid integer.
+        inline bool parse_int(const Token& token, int& value)
+        {
+            const char* cursor = token.begin;
+
+            const bool is_negative = (cursor != token.end && *cursor == '-');
+            if (cursor != token.end && (*cursor == '-' || *cursor == '+'))
+            {
+                ++cursor;
+            }
+            if (cursor == token.end)
+            {
+                return false;
+            }
+
+            value = 0;
+            for (; cursor != token.end; ++cursor)
+            {
+                if (!is_digit(*cursor))
+                {
+                    return false;
+                }
+                value = 10 * value + (*cursor - '0');
+            }
+            value = is_negative ? -value : value;
+
+            return true;
+        }
+
+        /// \brief Throw a parse error for a token that should have been a number.
+        /// \details The message is built here rather than by the callers to keep their hot paths small.
+        [[noreturn]] inline void
+        throw_number_error(const std::uint64_t line_number, const Token& token, const char* number_type)
+        {
+            if (token.empty())
+            {
+                throw_parse_error(line_number, std::string("Could not find an expected ") + number_type);
+            }
+            throw_parse_error(line_number, std::string("Found an invalid ") + number_type + " \"" + token.str() + "\"");
+        }
+
+        inline double Tokenizer::NextDouble()
+        {
+            const Token token = Next();
+
+            double value;
+            if (token.empty() || !parse_double(token, value))
+            {
+                throw_number_error(line_number_, token, "number");
+            }
+            return value;
+        }
+
+        inline int Tokenizer::NextInt()
+        {
+            const Token token = Next();
+
+            int value;
+            if (token.empty() || !parse_int(token, value))
+            {
+                throw_number_error(line_number_, token, "integer");
+            }
+            return value;
+        }
+
+        /// \brief Line reader that reuses a single line buffer, so that no allocation happens once the buffer has
+        ///        grown to the length of the longest line.
+        class StreamLineReader
+        {
+        public:
+            explicit StreamLineReader(std::istream& is) : is_(is) {}
+
+            /// \return A tokenizer for the next line, or false if there is no more line.
+            bool ReadLine(Tokenizer& tokenizer)
+            {
+                if (!std::getline(is_, buffer_))
+                {
+                    return false;
+                }
+                if (is_statistics_enabled())
+                {
+                    ++num_lines_;
+                }
+                ++line_number_;
+                tokenizer =
+                    Tokenizer(buffer_.data(), buffer_.data() + buffer_.size(), GetTokenCounter(), line_number_);
+                return true;
+            }
+
+            /// \brief Read the next line, which must exist.
+            Tokenizer ReadNextLine()
+            {
+                Tokenizer tokenizer(nullptr, nullptr);
+                if (!ReadLine(tokenizer))
+                {
+                    throw_parse_error(line_number_ + 1, "Found an unexpected end of the file");
+                }
+                return tokenizer;
+            }
+
+            /// \brief Read all the remaining characters at once into the line buffer.
+            /// \return The range of the read characters, which is valid until the next call of this reader.
+            std::pair<const char*, const char*> ReadRemaining()
+            {
+                buffer_.assign(std::istreambuf_iterator<char>(is_), std::istreambuf_iterator<char>());
+                return std::make_pair(buffer_.data(), buffer_.data() + buffer_.size());
+            }
+
+
+            /// \return The number of the last line read, which is used for parse errors.
+            std::uint64_t line_number() const { return line_number_; }
+
+            /// \return The number of the lines read so far (only counted with the statistics).
+            std::uint64_t num_lines() const { return num_lines_; }
+
+            /// \return The number of the tokens read so far (only counted with the statistics).
+            std::uint64_t num_tokens() const { return num_tokens_; }
+
+        private:
+            std::istream& is_;
+            std::string   buffer_;
+            std::uint64_t line_number_ = 0;
+            std::uint64_t num_lines_   = 0;
+            std::uint64_t num_tokens_  = 0;
+
+            std::uint64_t* GetTokenCounter() { return is_statistics_enabled() ? &num_tokens_ : nullptr; }
+        };
+
+        /// \brief Line reader that directly refers to an in-memory character range (e.g., a memory-mapped file),
+        ///        so that no line is copied.
+        class MemoryLineReader
+        {
+        public:
+            /// \param first_line_number Number of the line before the range, which is used for parse errors.
+            MemoryLineReader(const char* begin, const char* end, std::uint64_t first_line_number = 0)
+                : cursor_(begin),
+                  end_(end),
+                  line_number_(first_line_number)
+            {
+            }
+
+            /// \return A tokenizer for the next line, or false if there is no more line.
+            bool ReadLine(Tokenizer& tokenizer)
+            {
+                if (cursor_ == end_)
+                {
+                    return false;
+                }
+
+                const void* new_line = std::memchr(cursor_, '\n', static_cast<std::size_t>(end_ - cursor_));
+                const char* line_end = (new_line != nullptr) ? static_cast<const char*>(new_line) : end_;
+
+                if (is_statistics_enabled())
+                {
+                    ++num_lines_;
+                }
+                ++line_number_;
+                tokenizer = Tokenizer(cursor_, line_end, GetTokenCounter(), line_number_);
+                cursor_   = (line_end == end_) ? end_ : line_end + 1;
+
+                return true;
+            }
+
+            /// \brief Read the next line, which must exist.
+            Tokenizer ReadNextLine()
+            {
+                Tokenizer tokenizer(nullptr, nullptr);
+                if (!ReadLine(tokenizer))
+                {
+                    throw_parse_error(line_number_ + 1, "Found an unexpected end of the file");
+                }
+                return tokenizer;
+            }
+
+            /// \return The range of the characters that have not been read yet.
+            std::pair<const char*, const char*> ReadRemaining()
+            {
+                const std::pair<const char*, const char*> range(cursor_, end_);
+                cursor_ = end_;
+                return range;
+            }
+
+
+            /// \return The number of the last line read, which is used for parse errors.
+            std::uint64_t line_number() const { return line_number_; }
+
+            /// \return The number of the lines read so far (only counted with the statistics).
+            std::uint64_t num_lines() const { return num_lines_; }
+
+            /// \return The number of the tokens read so far (only counted with the statistics).
+            std::uint64_t num_tokens() const { return num_tokens_; }
+
+        private:
+            const char*   cursor_;
+            const char*   end_;
+            std::uint64_t line_number_;
+            std::uint64_t num_lines_  = 0;
+            std::uint64_t num_tokens_ = 0;
+
+            std::uint64_t* GetTokenCounter() { return is_statistics_enabled() ? &num_tokens_ : nullptr; }
+        };
+
+        /// \brief Read the three values that follow an "OFFSET" keyword.
+        inline Eigen::Vector3d read_offset(Tokenizer& tokenizer)
+        {
+            const double offset_x = tokenizer.NextDouble();
+            const double offset_y = tokenizer.NextDouble();
+            const double offset_z = tokenizer.NextDouble();
+            tokenizer.ExpectEnd("Found more than three values in an offset");
+
+            return Eigen::Vector3d(offset_x, offset_y, offset_z);
+        }
+
+        template <typename LineReader>
+        void expect_single_token_line(LineReader& reader, const char* expected_token)
+        {
+            Tokenizer tokenizer = reader.ReadNextLine();
+            if (tokenizer.Next() != expected_token)
+            {
+                tokenizer.Fail(std::string("Could not find an expected \"") + expected_token + "\"");
+            }
+            tokenizer.ExpectEnd("Found two or more tokens");
+        }
+
+        /// \brief Read the next token as a channel type.
+        inline Channel::Type read_channel_type(Tokenizer& tokenizer)
+        {
+            const Token channel_type = tokenizer.Next();
+
+            if (channel_type == "Xposition")
+            {
+                return Channel::Type::x_position;
+            }
+            if (channel_type == "Yposition")
+            {
+                return Channel::Type::y_position;
+            }
+            if (channel_type == "Zposition")
+            {
+                return Channel::Type::z_position;
+            }
+            if (channel_type == "Zrotation")
+            {
+                return Channel::Type::z_rotation;
+            }
+            if (channel_type == "Xrotation")
+            {
+                return Channel::Type::x_rotation;
+            }
+            if (channel_type == "Yrotation")
+            {
+                return Channel::Type::y_rotation;
+            }
+
+            tokenizer.Fail("Found an invalid channel type \"" + channel_type.str() + "\"");
+        }
+
+        /// \brief Read the HIERARCHY section, up to and including the "MOTION" line.
+        /// \details Malformed input is reported by std::runtime_error (see throw_parse_error).
+        /// \param arena Arena in which the joints are created, or null to create them on the heap.
+        template <typename LineReader>
+        void read_hierarchy(LineReader&                            reader,
+                            const double                           scale,
+                            std::shared_ptr<const Joint>&          root_joint,
+                            std::vector<Channel>&                  channels,
+                            const std::shared_ptr<HierarchyArena>& arena = nullptr)
+        {
+            Tokenizer                           tokenizer(nullptr, nullptr);
+            std::vector<std::shared_ptr<Joint>> stack;
+            while (reader.ReadLine(tokenizer))
+            {
+                // Read the first token of the line
+                const Token keyword = tokenizer.Next();
+
+                // Ignore empty lines
+                if (keyword.empty())
+                {
+                    continue;
+                }
+                // Ignore a declaration of hierarchy section
+                else if (keyword == "HIERARCHY")
+                {
+                    continue;
+                }
+                // Start to create a new joint
+                else if (keyword == "ROOT" || keyword == "JOINT")
+                {
+                    // Read the joint name
+                    const Token joint_name = tokenizer.Next();
+                    if (joint_name.empty())
+                    {
+                        tokenizer.Fail("Failed to find a joint name");
+                    }
+                    tokenizer.ExpectEnd("Found a joint name with white spaces");
+                    if (stack.empty() && root_joint)
+                    {
+                        tokenizer.Fail("Found a second root joint");
+                    }
+
+                    // Get a pointer for the parent if this is not a root joint
+                    const std::shared_ptr<Joint> parent = stack.empty() ? nullptr : stack.back();
+
+                    // Instantiate a new joint
+                    std::shared_ptr<Joint> new_joint = create_joint(joint_name.str(), parent, arena);
+
+                    // Register it to the parent's children list
+                    if (parent)
+                    {
+                        parent->AddChild(new_joint);
+                    }
+                    else
+                    {
+                        root_joint = new_joint;
+                    }
+
+                    // Add the new joint to the stack
+                    stack.push_back(new_joint);
+
+                    // Read the next line, which should be "{"
+                    expect_single_token_line(reader, "{");
+                }
+                // Read an offset value
+                else if (keyword == "OFFSET")
+                {
+                    if (stack.empty())
+                    {
+                        tokenizer.Fail("Found an OFFSET outside of joints");
+                    }
+                    const std::shared_ptr<Joint> current_joint = stack.back();
+                    current_joint->offset()                    = scale * read_offset(tokenizer);
+                }
+                // Read a channel list
+                else if (keyword == "CHANNELS")
+                {
+                    if (stack.empty())
+                    {
+                        tokenizer.Fail("Found CHANNELS outside of joints");
+                    }
+                    const int num_channels = tokenizer.NextInt();
+
+                    for (int i = 0; i < num_channels; ++i)
+                    {
+                        const std::shared_ptr<Joint> target_joint = stack.back();
+                        const Channel::Type          type         = read_channel_type(tokenizer);
+
+                        channels.push_back(Channel{type, target_joint});
+
+                        const int channel_index = static_cast<int>(channels.size() - 1);
+                        target_joint->AssociateChannel(channel_index);
+                    }
+                    tokenizer.ExpectEnd("Found more channels than declared");
+                }
+                // Read an end site
+                else if (keyword == "End")
+                {
+                    if (tokenizer.Next() != "Site")
+                    {
+                        tokenizer.Fail("Could not find an expected \"Site\"");
+                    }
+                    tokenizer.ExpectEnd("Found two or more tokens after \"End\"");
+                    if (stack.empty())
+                    {
+                        tokenizer.Fail("Found an end site outside of joints");
+                    }
+
+                    const std::shared_ptr<Joint> current_joint = stack.back();
+                    current_joint->has_end_site()              = true;
+
+                    // Read the next line, which should be "{"
+                    expect_single_token_line(reader, "{");
+
+                    // Read the next line, which should state an offset
+                    Tokenizer tokenizer_offset = reader.ReadNextLine();
+                    if (tokenizer_offset.Next() != "OFFSET")
+                    {
+                        tokenizer_offset.Fail("Could not find the OFFSET of an end site");
+                    }
+                    current_joint->end_site() = scale * read_offset(tokenizer_offset);
+
+                    // Read the next line, which should be "}"
+                    expect_single_token_line(reader, "}");
+                }
+                // Finish to create a joint
+                else if (keyword == "}")
+                {
+                    if (stack.empty())
+                    {
+                        tokenizer.Fail("Found an unmatched \"}\"");
+                    }
+                    stack.pop_back();
+                }
+                // Stop this iteration and go to the motion section
+                else if (keyword == "MOTION")
+                {
+                    if (!root_joint)
+                    {
+                        tokenizer.Fail("Could not find the ROOT joint");
+                    }
+                    if (!stack.empty())
+                    {
+                        tokenizer.Fail("Found a joint that is not closed");
+                    }
+                    return;
+                }
+            }
+            throw_parse_error(reader.line_number(), "Could not find the MOTION section");
+        }
+
+        /// \brief Read the "Frames:" and "Frame Time:" lines that open the MOTION section.
+        template <typename LineReader>
+        void read_motion_header(LineReader& reader, int& frames, double& frame_time)
+        {
+            // Read the number of frames
+            Tokenizer tokenizer_frames = reader.ReadNextLine();
+            if (tokenizer_frames.Next() != "Frames:")
+            {
+                tokenizer_frames.Fail("Could not find an expected \"Frames:\"");
+            }
+            frames = tokenizer_frames.NextInt();
+            if (frames < 0)
+            {
+                tokenizer_frames.Fail("Found a negative number of frames");
+            }
+            tokenizer_frames.ExpectEnd("Found two or more numbers of frames");
+
+            // Read the frame time
+            Tokenizer   tokenizer_frame_time = reader.ReadNextLine();
+            const Token frame_keyword        = tokenizer_frame_time.Next();
+            const Token time_keyword         = tokenizer_frame_time.Next();
+            if (frame_keyword != "Frame" || time_keyword != "Time:")
+            {
+                tokenizer_frame_time.Fail("Could not find an expected \"Frame Time:\"");
+            }
+            frame_time = tokenizer_frame_time.NextDouble();
+            tokenizer_frame_time.ExpectEnd("Found two or more frame times");
+        }
+
+        /// \brief Parse the values of a frame line into a row of a motion matrix.
+        /// \param frame_index Index of the row to be written.
+        inline void read_frame(Tokenizer& tokenizer, const int frame_index, Eigen::MatrixXd& motion)
+        {
+            for (int channel_index = 0; channel_index < motion.cols(); ++channel_index)
+            {
+                motion(frame_index, channel_index) = tokenizer.NextDouble();
+            }
+            tokenizer.ExpectEnd("Found more values than the channels");
+        }
+
+        /// \brief Read the frame lines of the MOTION section.
+        template <typename LineReader>
+        void read_frames(LineReader& reader, Eigen::MatrixXd& motion)
+        {
+            for (int frame_index = 0; frame_index < motion.rows(); ++frame_index)
+            {
+                Tokenizer tokenizer = reader.ReadNextLine();
+                read_frame(tokenizer, frame_index, motion);
+            }
+        }
+
+        /// \brief Read the frame lines of the MOTION section in parallel.
+        /// \details The remaining characters are split into chunks at line boundaries. Lines are first counted per
+        ///          chunk to know the frame index of the first line of each chunk, and then every chunk is parsed
+        ///          directly into its rows of the motion matrix. Both phases run on the worker threads. Parse errors
+        ///          report the line numbers in the whole file.
+        template <typename LineReader>
+        void read_frames_parallel(LineReader& reader, Eigen::MatrixXd& motion, const int num_threads)
+        {
+            const std::uint64_t                       first_line_number = reader.line_number();
+            const std::pair<const char*, const char*> range             = reader.ReadRemaining();
+
+            const char* const begin = range.first;
+            const char* const end   = range.second;
+
+            // Use more chunks than threads so that the workload is balanced
+            constexpr int         num_chunks_per_thread = 8;
+            constexpr std::size_t min_chunk_size        = 1 << 16;
+
+            const std::size_t num_bytes   = static_cast<std::size_t>(end - begin);
+            const int         num_workers = resolve_num_threads(num_threads);
+            const std::size_t max_chunks  = std::max(std::size_t(1), num_bytes / min_chunk_size);
+            const std::size_t num_tasks   = static_cast<std::size_t>(num_workers * num_chunks_per_thread);
+            const int         num_chunks  = static_cast<int>(std::min(max_chunks, num_tasks));
+
+            // Determine the chunk boundaries, each of which is placed just after a new-line character
+            std::vector<const char*> boundaries(num_chunks + 1, end);
+            boundaries[0] = begin;
+            for (int chunk_index = 1; chunk_index < num_chunks; ++chunk_index)
+            {
+                const char* target   = begin + chunk_index * (num_bytes / num_chunks);
+                const char* position = std::max(boundaries[chunk_index - 1], target);
+                const void* new_line = std::memchr(position, '\n', static_cast<std::size_t>(end - position));
+
+                boundaries[chunk_index] = (new_line != nullptr) ? static_cast<const char*>(new_line) + 1 : end;
+            }
+
+            // Count the lines in each chunk
+            std::vector<int> first_frame_indices(num_chunks + 1, 0);
+            auto             count_lines = [&](const int chunk_index) -> void
+            {
+                const char* chunk_end = boundaries[chunk_index + 1];
+
+                int num_lines = 0;
+                for (const char* position = boundaries[chunk_index]; position != chunk_end; ++num_lines)
+                {
+                    const void* new_line = std::memchr(position, '\n', static_cast<std::size_t>(chunk_end - position));
+                    position             = (new_line != nullptr) ? static_cast<const char*>(new_line) + 1 : chunk_end;
+                }
+                first_frame_indices[chunk_index + 1] = num_lines;
+            };
+            parallel_for(num_chunks, num_workers, count_lines);
+
+            // Accumulate the counts to obtain the frame index of the first line of each chunk
+            for (int chunk_index = 0; chunk_index < num_chunks; ++chunk_index)
+            {
+                first_frame_indices[chunk_index + 1] += first_frame_indices[chunk_index];
+            }
+            if (first_frame_indices[num_chunks] < motion.rows())
+            {
+                throw_parse_error(first_line_number + first_frame_indices[num_chunks] + 1,
+                                  "Found an unexpected end of the file");
+            }
+
+            // Parse the lines of each chunk into the corresponding rows
+            auto parse_lines = [&](const int chunk_index) -> void
+            {
+                MemoryLineReader chunk_reader(boundaries[chunk_index],
+                                              boundaries[chunk_index + 1],
+                                              first_line_number + first_frame_indices[chunk_index]);
+                Tokenizer        tokenizer(nullptr, nullptr);
+
+                const int num_frames  = static_cast<int>(motion.rows());
+                const int frame_begin = std::min(first_frame_indices[chunk_index], num_frames);
+                const int frame_end   = std::min(first_frame_indices[chunk_index + 1], num_frames);
+                for (int frame_index = frame_begin; frame_index < frame_end; ++frame_index)
+                {
+                    chunk_reader.ReadLine(tokenizer);
+                    read_frame(tokenizer, frame_index, motion);
+                }
+            };
+            parallel_for(num_chunks, num_workers, parse_lines);
+        }
+
+        /// \brief Multiply the values of the translation channels by the scale factor.
+        inline void
+        scale_translations(const std::vector<Channel>& channels, const double scale, Eigen::MatrixXd& motion)
+        {
+            for (int channel_index = 0; channel_index < static_cast<int>(channels.size()); ++channel_index)
+            {
+                const Channel::Type& type = channels[channel_index].type;
+                if (type == Channel::Type::x_position || type == Channel::Type::y_position ||
+                    type == Channel::Type::z_position)
+                {
+                    motion.col(channel_index) = scale * motion.col(channel_index);
+                }
+            }
+        }
+    } // namespace internal
+} // namespace bvh11
+
+#endif
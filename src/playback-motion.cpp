@@ -0,0 +1,128 @@
+#include "batch-kinematics.hpp"
+#include "rotation-kernels.hpp"
+#include "statistics.hpp"
+#include <bvh11/playback-motion.hpp>
+#include <cassert>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Dispatch compute_euler_rotation on the rotation order, which must be a standard one.
+        template <typename Scalar>
+        inline Eigen::Matrix<Scalar, 3, 3>
+        compute_euler_rotation(RotationOrder order, Scalar angle_0, Scalar angle_1, Scalar angle_2)
+        {
+            switch (order)
+            {
+                case RotationOrder::xyz:
+                    return compute_euler_rotation<0, 1, 2>(angle_0, angle_1, angle_2);
+                case RotationOrder::xzy:
+                    return compute_euler_rotation<0, 2, 1>(angle_0, angle_1, angle_2);
+                case RotationOrder::yxz:
+                    return compute_euler_rotation<1, 0, 2>(angle_0, angle_1, angle_2);
+                case RotationOrder::yzx:
+                    return compute_euler_rotation<1, 2, 0>(angle_0, angle_1, angle_2);
+                case RotationOrder::zxy:
+                    return compute_euler_rotation<2, 0, 1>(angle_0, angle_1, angle_2);
+                case RotationOrder::zyx:
+                    return compute_euler_rotation<2, 1, 0>(angle_0, angle_1, angle_2);
+                case RotationOrder::none:
+                case RotationOrder::generic:
+                    break;
+            }
+            return Eigen::Matrix<Scalar, 3, 3>::Identity();
+        }
+    } // namespace internal
+
+    template <typename StorageScalar>
+    PlaybackMotion<StorageScalar>::PlaybackMotion(const BvhObject& bvh)
+        : skeleton_(bvh.skeleton()),
+          frame_time_(bvh.frame_time()),
+          motion_(bvh.motion().template cast<StorageScalar>()),
+          offsets_(bvh.skeleton()->offsets().template cast<Scalar>())
+    {
+    }
+
+    template <typename StorageScalar>
+    PlaybackMotion<StorageScalar>::PlaybackMotion(const std::string& file_path, const LoadOptions& options)
+        : PlaybackMotion(BvhObject(file_path, options))
+    {
+    }
+
+    template <typename StorageScalar>
+    typename PlaybackMotion<StorageScalar>::Transform
+    PlaybackMotion<StorageScalar>::ComputeLocalTransform(int joint_index, int frame) const
+    {
+        assert(frame < frames() && "Invalid frame is specified.");
+
+        const RotationOrder order = skeleton_->rotation_orders()[joint_index];
+        if (order == RotationOrder::generic)
+        {
+            Eigen::VectorXd buffer;
+            return internal::compute_generic_local_transform(*skeleton_, joint_index, motion_, frame, buffer)
+                .template cast<Scalar>();
+        }
+
+        const Eigen::Index   stride         = motion_.rows();
+        const StorageScalar* channel_values = motion_.data() + frame;
+
+        channel_values += skeleton_->channel_starts()[joint_index] * stride;
+
+        auto value = [&](int k) -> Scalar { return static_cast<Scalar>(channel_values[k * stride]); };
+
+        Transform transform = Transform::Identity();
+
+        // Apply either time-varying translation or intrinsic offset translation
+        if (skeleton_->has_translation_channels()[joint_index])
+        {
+            transform.translation() << value(0), value(1), value(2);
+            channel_values += 3 * stride;
+        }
+        else
+        {
+            transform.translation() = offsets_.col(joint_index);
+        }
+
+        if (order != RotationOrder::none)
+        {
+            transform.linear() = internal::compute_euler_rotation(order, value(0), value(1), value(2));
+        }
+
+        return transform;
+    }
+
+    template <typename StorageScalar>
+    void PlaybackMotion<StorageScalar>::ComputeGlobalTransforms(int frame, TransformList& transforms) const
+    {
+        const internal::KinematicsRecorder recorder(skeleton_->num_joints());
+
+        transforms.resize(skeleton_->num_joints());
+        for (int joint_index = 0; joint_index < skeleton_->num_joints(); ++joint_index)
+        {
+            const int parent_index = skeleton_->parent_indices()[joint_index];
+            if (parent_index < 0)
+            {
+                transforms[joint_index] = ComputeLocalTransform(joint_index, frame);
+            }
+            else
+            {
+                transforms[joint_index] = transforms[parent_index] * ComputeLocalTransform(joint_index, frame);
+            }
+        }
+    }
+
+    template <typename StorageScalar>
+    void PlaybackMotion<StorageScalar>::ComputeGlobalPositions(int             frame_begin,
+                                                               int             frame_end,
+                                                               PositionMatrix& positions) const
+    {
+        const internal::KinematicsRecorder recorder(skeleton_->num_joints() * std::uint64_t(frame_end - frame_begin));
+
+        internal::compute_global_positions(*skeleton_, motion_, frame_begin, frame_end, positions);
+    }
+
+    template class PlaybackMotion<double>;
+    template class PlaybackMotion<float>;
+    template class PlaybackMotion<Eigen::half>;
+} // namespace bvh11
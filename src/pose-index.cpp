@@ -0,0 +1,441 @@
+#include "binary-format.hpp"
+#include "mapped-file.hpp"
+#include "parallel-for.hpp"
+#include <algorithm>
+#include <bvh11/pose-index.hpp>
+#include <cassert>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        constexpr char          pose_index_magic[8]   = {'B', 'V', 'H', '1', '1', 'I', 'D', 'X'};
+        constexpr std::uint32_t pose_index_version    = 1;
+        constexpr std::size_t   pose_index_alignment  = 64;
+        constexpr int           pose_index_leaf_size  = 16;
+        constexpr int           pose_queries_per_task = 64;
+
+        /// \brief Fixed-size part at the beginning of a pose index file.
+        struct PoseIndexHeader
+        {
+            char          magic[8];
+            std::uint32_t version;
+            std::uint32_t byte_order;
+            std::int32_t  num_features;
+            std::int32_t  num_trees;
+        };
+    } // namespace internal
+
+    struct PoseIndex::SearchBuffers
+    {
+        /// \brief Subtree waiting to be visited with the lower bound of its squared distance.
+        struct Entry
+        {
+            double      lower_bound;
+            int         tree_index;
+            int         node_index;
+            std::size_t offsets_begin;
+        };
+
+        /// \brief Min-heap of the entries ordered by the lower bounds.
+        std::vector<Entry> heap;
+
+        /// \brief Per-dimension distances from the query to the cell of each entry, stored entry by entry.
+        std::vector<double> offsets;
+
+        std::vector<double> current_offsets;
+    };
+
+    PoseIndex::PoseIndex(int num_features) : num_features_(num_features)
+    {
+        assert(num_features > 0 && "Invalid number of features is specified.");
+    }
+
+    PoseIndex::PoseIndex(const std::string& file_path)
+    {
+        // Read the whole file from a memory mapping if possible; otherwise, through a stream. Either way, the arrays
+        // are copied into the trees, so the index does not refer to the file after loading.
+        internal::MappedFile mapped_file;
+        std::vector<char>    buffer;
+        const char*          begin;
+        const char*          end;
+        if (mapped_file.Open(file_path))
+        {
+            begin = mapped_file.data();
+            end   = mapped_file.data() + mapped_file.size();
+        }
+        else
+        {
+            std::ifstream ifs(file_path, std::ios::binary);
+            if (!ifs.is_open())
+            {
+                throw std::runtime_error("Failed to open the input file.");
+            }
+
+            buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+            begin = buffer.data();
+            end   = buffer.data() + buffer.size();
+        }
+
+        internal::BinaryReader reader(begin, end);
+
+        const internal::PoseIndexHeader header = reader.Read<internal::PoseIndexHeader>();
+        if (std::memcmp(header.magic, internal::pose_index_magic, sizeof(header.magic)) != 0)
+        {
+            throw std::runtime_error("Not a bvh11 pose index file.");
+        }
+        if (header.version != internal::pose_index_version)
+        {
+            throw std::runtime_error("Unsupported pose index version " + std::to_string(header.version) + ".");
+        }
+        if (header.byte_order != internal::binary_byte_order)
+        {
+            throw std::runtime_error("The pose index file was written with a different byte order.");
+        }
+        if (header.num_features <= 0 || header.num_trees < 0)
+        {
+            throw std::runtime_error("Found an invalid pose index header.");
+        }
+
+        num_features_ = header.num_features;
+
+        // Check the sizes against the file before allocating, so that a corrupted size is not trusted
+        if (std::uint64_t(header.num_trees) * 2 * sizeof(std::int32_t) > reader.remaining())
+        {
+            throw std::runtime_error("Found a truncated binary file.");
+        }
+
+        trees_.resize(header.num_trees);
+        for (Tree& tree : trees_)
+        {
+            const std::int32_t num_nodes  = reader.Read<std::int32_t>();
+            const std::int32_t num_points = reader.Read<std::int32_t>();
+            if (num_nodes < 0 || num_points < 0)
+            {
+                throw std::runtime_error("Found an invalid tree in the pose index file.");
+            }
+
+            const std::uint64_t point_size = sizeof(double) * std::uint64_t(num_features_) + sizeof(std::int32_t);
+            if (std::uint64_t(num_nodes) * sizeof(Node) + std::uint64_t(num_points) * point_size > reader.remaining())
+            {
+                throw std::runtime_error("Found a truncated binary file.");
+            }
+
+            tree.nodes.resize(num_nodes);
+            tree.points.resize(num_points, num_features_);
+            tree.frames.resize(num_points);
+
+            reader.SkipTo(internal::pose_index_alignment);
+            reader.ReadBytes(reinterpret_cast<char*>(tree.nodes.data()), sizeof(Node) * tree.nodes.size());
+            reader.SkipTo(internal::pose_index_alignment);
+            reader.ReadBytes(reinterpret_cast<char*>(tree.points.data()), sizeof(double) * tree.points.size());
+            reader.SkipTo(internal::pose_index_alignment);
+            reader.ReadBytes(reinterpret_cast<char*>(tree.frames.data()), sizeof(std::int32_t) * tree.frames.size());
+
+            ValidateTree(tree, num_features_);
+        }
+    }
+
+    void PoseIndex::ValidateTree(const Tree& tree, int num_features)
+    {
+        const int num_nodes  = static_cast<int>(tree.nodes.size());
+        const int num_points = static_cast<int>(tree.frames.size());
+
+        // Every query starts from the root, which covers all the points
+        if (num_nodes == 0 || tree.nodes[0].begin != 0 || tree.nodes[0].end != num_points)
+        {
+            throw std::runtime_error("Found an invalid tree in the pose index file.");
+        }
+
+        for (int node_index = 0; node_index < num_nodes; ++node_index)
+        {
+            const Node& node = tree.nodes[node_index];
+
+            const bool is_valid_range = 0 <= node.begin && node.begin <= node.end && node.end <= num_points;
+
+            // Children come after their parents, so descending from any node always reaches a leaf
+            const bool is_valid_split =
+                node.split_dimension == -1 ||
+                (0 <= node.split_dimension && node.split_dimension < num_features && node_index + 1 < num_nodes &&
+                 node_index + 1 < node.right_child && node.right_child < num_nodes);
+
+            if (!is_valid_range || !is_valid_split)
+            {
+                throw std::runtime_error("Found an invalid node in the pose index file.");
+            }
+        }
+    }
+
+    int PoseIndex::size() const
+    {
+        int num_frames = 0;
+        for (const Tree& tree : trees_)
+        {
+            num_frames += static_cast<int>(tree.frames.size());
+        }
+        return num_frames;
+    }
+
+    void PoseIndex::AddFrames(const Eigen::MatrixXd& features, int first_frame)
+    {
+        assert(features.cols() == num_features_ && "The features do not match the index.");
+
+        if (features.rows() == 0)
+        {
+            return;
+        }
+
+        RowMajorMatrixXd          points = features;
+        std::vector<std::int32_t> frames(features.rows());
+        std::iota(frames.begin(), frames.end(), first_frame);
+
+        // Merge the trees that are not larger than the new one, as in adding binary numbers
+        while (!trees_.empty() && trees_.back().frames.size() <= frames.size())
+        {
+            const Tree& last_tree = trees_.back();
+
+            RowMajorMatrixXd merged_points(last_tree.points.rows() + points.rows(), num_features_);
+            merged_points << last_tree.points, points;
+
+            points = std::move(merged_points);
+            frames.insert(frames.begin(), last_tree.frames.begin(), last_tree.frames.end());
+
+            trees_.pop_back();
+        }
+
+        trees_.push_back(BuildTree(std::move(points), std::move(frames)));
+    }
+
+    PoseIndex::Tree PoseIndex::BuildTree(RowMajorMatrixXd points, std::vector<std::int32_t> frames)
+    {
+        const int num_points   = static_cast<int>(points.rows());
+        const int num_features = static_cast<int>(points.cols());
+
+        std::vector<std::int32_t> order(num_points);
+        std::iota(order.begin(), order.end(), 0);
+
+        Tree tree;
+
+        // Split the points at the median of the dimension with the largest spread until the leaves are small enough
+        std::function<int(int, int)> build_node = [&](int begin, int end) -> int
+        {
+            const int node_index = static_cast<int>(tree.nodes.size());
+            tree.nodes.push_back(Node{0.0, -1, -1, begin, end});
+
+            if (end - begin <= internal::pose_index_leaf_size)
+            {
+                return node_index;
+            }
+
+            Eigen::VectorXd minimum = points.row(order[begin]).transpose();
+            Eigen::VectorXd maximum = minimum;
+            for (int i = begin + 1; i < end; ++i)
+            {
+                minimum = minimum.cwiseMin(points.row(order[i]).transpose());
+                maximum = maximum.cwiseMax(points.row(order[i]).transpose());
+            }
+
+            Eigen::Index split_dimension;
+            if ((maximum - minimum).maxCoeff(&split_dimension) == 0.0)
+            {
+                // All the points are the same, so they cannot be split
+                return node_index;
+            }
+
+            const int middle = (begin + end) / 2;
+            std::nth_element(order.begin() + begin,
+                             order.begin() + middle,
+                             order.begin() + end,
+                             [&](const std::int32_t a, const std::int32_t b) -> bool
+                             { return points(a, split_dimension) < points(b, split_dimension); });
+
+            tree.nodes[node_index].split_value     = points(order[middle], split_dimension);
+            tree.nodes[node_index].split_dimension = static_cast<std::int32_t>(split_dimension);
+
+            build_node(begin, middle);
+            const int right_child = build_node(middle, end);
+
+            tree.nodes[node_index].right_child = right_child;
+
+            return node_index;
+        };
+        build_node(0, num_points);
+
+        // Store the points in the order of the leaves
+        tree.points.resize(num_points, num_features);
+        tree.frames.resize(num_points);
+        for (int i = 0; i < num_points; ++i)
+        {
+            tree.points.row(i) = points.row(order[i]);
+            tree.frames[i]     = frames[order[i]];
+        }
+
+        return tree;
+    }
+
+    NearestFrame
+    PoseIndex::Search(const double* query, const PoseSearchOptions& options, SearchBuffers& buffers) const
+    {
+        using Entry = SearchBuffers::Entry;
+
+        const Eigen::Map<const Eigen::RowVectorXd> query_vector(query, num_features_);
+
+        std::vector<Entry>&  heap    = buffers.heap;
+        std::vector<double>& offsets = buffers.offsets;
+        std::vector<double>& current = buffers.current_offsets;
+
+        auto is_farther = [](const Entry& a, const Entry& b) -> bool { return a.lower_bound > b.lower_bound; };
+
+        auto push = [&](const double lower_bound, const int tree_index, const int node_index) -> void
+        {
+            heap.push_back(Entry{lower_bound, tree_index, node_index, offsets.size()});
+            offsets.insert(offsets.end(), current.begin(), current.end());
+            std::push_heap(heap.begin(), heap.end(), is_farther);
+        };
+
+        heap.clear();
+        offsets.clear();
+        current.assign(num_features_, 0.0);
+        for (int tree_index = 0; tree_index < num_trees(); ++tree_index)
+        {
+            push(0.0, tree_index, 0);
+        }
+
+        // Visit the subtrees in the order of their lower bounds (i.e., best-bin-first), where the bounds are updated
+        // incrementally from the distances to the cells along each dimension
+        NearestFrame nearest    = {-1, std::numeric_limits<double>::infinity()};
+        int          num_visits = 0;
+        while (!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), is_farther);
+            const Entry entry = heap.back();
+            heap.pop_back();
+
+            if (entry.lower_bound >= nearest.squared_distance ||
+                (options.max_leaf_visits > 0 && num_visits >= options.max_leaf_visits))
+            {
+                break;
+            }
+
+            const Tree& tree = trees_[entry.tree_index];
+
+            std::copy(offsets.begin() + entry.offsets_begin,
+                      offsets.begin() + entry.offsets_begin + num_features_,
+                      current.begin());
+
+            // Descend to the leaf on the side of the query while deferring the other sides
+            int node_index = entry.node_index;
+            while (tree.nodes[node_index].split_dimension >= 0)
+            {
+                const Node&  node       = tree.nodes[node_index];
+                const int    dimension  = node.split_dimension;
+                const double difference = query[dimension] - node.split_value;
+                const int    near_child = difference < 0.0 ? node_index + 1 : node.right_child;
+                const int    far_child  = difference < 0.0 ? node.right_child : node_index + 1;
+
+                const double far_lower_bound =
+                    entry.lower_bound - current[dimension] * current[dimension] + difference * difference;
+                if (far_lower_bound < nearest.squared_distance)
+                {
+                    const double offset = current[dimension];
+                    current[dimension]  = difference;
+                    push(far_lower_bound, entry.tree_index, far_child);
+                    current[dimension] = offset;
+                }
+
+                node_index = near_child;
+            }
+
+            // Scan the points of the leaf, which are contiguous
+            const Node& leaf = tree.nodes[node_index];
+            for (int i = leaf.begin; i < leaf.end; ++i)
+            {
+                const double squared_distance = (tree.points.row(i) - query_vector).squaredNorm();
+                if (squared_distance < nearest.squared_distance)
+                {
+                    nearest = NearestFrame{tree.frames[i], squared_distance};
+                }
+            }
+            ++num_visits;
+        }
+
+        return nearest;
+    }
+
+    NearestFrame PoseIndex::FindNearestFrame(const Eigen::VectorXd& query, const PoseSearchOptions& options) const
+    {
+        assert(query.size() == num_features_ && "The query does not match the index.");
+
+        SearchBuffers buffers;
+        return Search(query.data(), options, buffers);
+    }
+
+    void PoseIndex::FindNearestFrames(const Eigen::MatrixXd&     queries,
+                                      std::vector<NearestFrame>& results,
+                                      const PoseSearchOptions&   options) const
+    {
+        assert(queries.cols() == num_features_ && "The queries do not match the index.");
+
+        const int num_queries = static_cast<int>(queries.rows());
+        const int num_tasks   = (num_queries + internal::pose_queries_per_task - 1) / internal::pose_queries_per_task;
+
+        results.resize(num_queries);
+
+        // Each task reuses its buffers across its queries
+        auto search_queries = [&](const int task_index) -> void
+        {
+            const int query_begin = task_index * internal::pose_queries_per_task;
+            const int query_end   = std::min(query_begin + internal::pose_queries_per_task, num_queries);
+
+            SearchBuffers   buffers;
+            Eigen::VectorXd query;
+            for (int query_index = query_begin; query_index < query_end; ++query_index)
+            {
+                query                = queries.row(query_index).transpose();
+                results[query_index] = Search(query.data(), options, buffers);
+            }
+        };
+        internal::parallel_for(num_tasks, options.num_threads, search_queries);
+    }
+
+    void PoseIndex::WriteFile(const std::string& file_path) const
+    {
+        internal::PoseIndexHeader header;
+        std::memcpy(header.magic, internal::pose_index_magic, sizeof(header.magic));
+        header.version      = internal::pose_index_version;
+        header.byte_order   = internal::binary_byte_order;
+        header.num_features = num_features_;
+        header.num_trees    = num_trees();
+
+        internal::BinaryWriter writer;
+        writer.Write(header);
+
+        // Align each array to a cache line (the loader copies each of them with a single memcpy)
+        for (const Tree& tree : trees_)
+        {
+            writer.Write(static_cast<std::int32_t>(tree.nodes.size()));
+            writer.Write(static_cast<std::int32_t>(tree.frames.size()));
+
+            writer.PadTo(internal::pose_index_alignment);
+            writer.WriteBytes(reinterpret_cast<const char*>(tree.nodes.data()), sizeof(Node) * tree.nodes.size());
+            writer.PadTo(internal::pose_index_alignment);
+            writer.WriteBytes(reinterpret_cast<const char*>(tree.points.data()), sizeof(double) * tree.points.size());
+            writer.PadTo(internal::pose_index_alignment);
+            writer.WriteBytes(reinterpret_cast<const char*>(tree.frames.data()),
+                              sizeof(std::int32_t) * tree.frames.size());
+        }
+
+        // Open the output file
+        std::ofstream ofs(file_path, std::ios::binary);
+        assert(ofs.is_open() && "Failed to open the output file.");
+
+        ofs.write(writer.buffer().data(), writer.buffer().size());
+    }
+} // namespace bvh11
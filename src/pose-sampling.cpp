@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <bvh11.hpp>
+#include <bvh11/pose.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+#include <cmath>
+
+namespace bvh11
+{
+    void BvhObject::SamplePose(double time_seconds, Pose& pose, SamplingMode mode) const
+    {
+        assert(frames_ > 0 && "The object has no frame.");
+        assert(frame_time_ > 0.0 && "Invalid frame time.");
+
+        const int num_joints = skeleton_->num_joints();
+        pose.rotations.resize(num_joints);
+        pose.translations.resize(num_joints);
+
+        // Find the two neighboring frames and the interpolation weight
+        const double position = time_seconds / frame_time_;
+
+        int    frame_0 = 0;
+        int    frame_1 = 0;
+        double weight  = 0.0;
+        switch (mode)
+        {
+            case SamplingMode::clamp:
+            {
+                const double clamped = std::min(std::max(position, 0.0), static_cast<double>(frames_ - 1));
+
+                frame_0 = std::min(static_cast<int>(clamped), frames_ - 1);
+                frame_1 = std::min(frame_0 + 1, frames_ - 1);
+                weight  = clamped - frame_0;
+                break;
+            }
+            case SamplingMode::loop:
+            {
+                const double wrapped = position - frames_ * std::floor(position / frames_);
+
+                frame_0 = std::min(static_cast<int>(wrapped), frames_ - 1);
+                frame_1 = (frame_0 + 1 == frames_) ? 0 : frame_0 + 1;
+                weight  = std::min(std::max(wrapped - frame_0, 0.0), 1.0);
+                break;
+            }
+        }
+
+        const double*      values_0 = motion_.data() + frame_0;
+        const double*      values_1 = motion_.data() + frame_1;
+        const Eigen::Index stride   = motion_.rows();
+
+        // Read the rotations from the cache if available
+        const Eigen::Quaterniond* cached_rotations_0 = has_rotation_cache() ? GetCachedRotations(frame_0) : nullptr;
+        const Eigen::Quaterniond* cached_rotations_1 = has_rotation_cache() ? GetCachedRotations(frame_1) : nullptr;
+
+        auto compute_rotation = [&](const int                 joint_index,
+                                    const double*             values,
+                                    const Eigen::Quaterniond* cached_rotations) -> Eigen::Quaterniond
+        {
+            return (cached_rotations != nullptr) ? cached_rotations[joint_index]
+                                                 : skeleton_->ComputeLocalRotation(joint_index, values, stride);
+        };
+
+        // Skip the interpolation when the time is exactly on a frame
+        if (weight == 0.0)
+        {
+            for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+            {
+                pose.rotations[joint_index]    = compute_rotation(joint_index, values_0, cached_rotations_0);
+                pose.translations[joint_index] = skeleton_->ComputeLocalTranslation(joint_index, values_0, stride);
+            }
+            return;
+        }
+
+        for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+        {
+            const Eigen::Quaterniond rotation_0 = compute_rotation(joint_index, values_0, cached_rotations_0);
+            const Eigen::Quaterniond rotation_1 = compute_rotation(joint_index, values_1, cached_rotations_1);
+
+            pose.rotations[joint_index] = rotation_0.slerp(weight, rotation_1);
+
+            if (skeleton_->has_translation_channels()[joint_index] ||
+                skeleton_->rotation_orders()[joint_index] == RotationOrder::generic)
+            {
+                const Eigen::Vector3d translation_0 =
+                    skeleton_->ComputeLocalTranslation(joint_index, values_0, stride);
+                const Eigen::Vector3d translation_1 =
+                    skeleton_->ComputeLocalTranslation(joint_index, values_1, stride);
+
+                pose.translations[joint_index] = (1.0 - weight) * translation_0 + weight * translation_1;
+            }
+            else
+            {
+                pose.translations[joint_index] = skeleton_->offsets().col(joint_index);
+            }
+        }
+    }
+} // namespace bvh11
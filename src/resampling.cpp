@@ -0,0 +1,202 @@
+#include "parallel-for.hpp"
+#include "rotation-kernels.hpp"
+#include <algorithm>
+#include <bvh11.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+#include <cmath>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Number of the new frames processed by a task of the resampling.
+        constexpr int resampling_chunk_size = 1024;
+
+        /// \brief How the values of a channel are interpolated.
+        enum class ChannelInterpolation
+        {
+            /// \brief Linear interpolation (e.g., for translations).
+            linear,
+
+            /// \brief Linear interpolation along the shorter way around the circle (for rotation channels that are
+            ///        not part of a standard rotation order).
+            angle,
+
+            /// \brief Slerp of the rotation of the joint.
+            rotation
+        };
+    } // namespace internal
+
+    BvhObject::BvhObject(const BvhObject& other, int frames, double frame_time)
+        : frames_(frames),
+          frame_time_(frame_time),
+          channels_(other.channels_),
+          motion_(frames, other.channels_.size()),
+          root_joint_(other.root_joint_),
+          joint_list_(other.joint_list_),
+          joint_indices_(other.joint_indices_),
+          parent_indices_(other.parent_indices_),
+          skeleton_(other.skeleton_),
+          hierarchy_arena_(other.hierarchy_arena_)
+    {
+    }
+
+    BvhObject BvhObject::Resample(double frame_time, int num_threads) const
+    {
+        assert(frame_time > 0.0 && frame_time_ > 0.0 && "Invalid frame time.");
+
+        // Keep the duration; a small tolerance avoids dropping the last frame due to rounding errors
+        const double duration   = (frames_ - 1) * frame_time_;
+        const int    num_frames = frames_ == 0 ? 0 : static_cast<int>(std::floor(duration / frame_time + 1e-6)) + 1;
+
+        BvhObject resampled(*this, num_frames, frame_time);
+
+        // Find the two neighboring original frames and the interpolation weight of each new frame
+        Eigen::ArrayXi source_frames_0(num_frames);
+        Eigen::ArrayXi source_frames_1(num_frames);
+        Eigen::ArrayXd weights(num_frames);
+        for (int frame = 0; frame < num_frames; ++frame)
+        {
+            double position = frame * frame_time / frame_time_;
+
+            // Snap to the original frame when it is almost exactly on it so that its values are copied exactly
+            if (std::abs(position - std::round(position)) < 1e-6)
+            {
+                position = std::round(position);
+            }
+
+            source_frames_0(frame) = std::min(static_cast<int>(position), frames_ - 1);
+            source_frames_1(frame) = std::min(source_frames_0(frame) + 1, frames_ - 1);
+            weights(frame)         = position - source_frames_0(frame);
+        }
+
+        // Classify the channels
+        const int num_joints   = skeleton_->num_joints();
+        const int num_channels = static_cast<int>(channels_.size());
+
+        using internal::ChannelInterpolation;
+
+        std::vector<ChannelInterpolation> interpolations(num_channels, ChannelInterpolation::linear);
+        std::vector<int>                  rotation_joint_indices;
+        for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+        {
+            const RotationOrder order = skeleton_->rotation_orders()[joint_index];
+            const int           start = skeleton_->channel_starts()[joint_index];
+            const int           count = skeleton_->channel_counts()[joint_index];
+            if (order == RotationOrder::none)
+            {
+                continue;
+            }
+            else if (order == RotationOrder::generic)
+            {
+                for (int channel_index = start; channel_index < start + count; ++channel_index)
+                {
+                    const Channel::Type type = channels_[channel_index].type;
+                    if (type == Channel::Type::x_rotation || type == Channel::Type::y_rotation ||
+                        type == Channel::Type::z_rotation)
+                    {
+                        interpolations[channel_index] = ChannelInterpolation::angle;
+                    }
+                }
+            }
+            else
+            {
+                const int rotation_start = start + (skeleton_->has_translation_channels()[joint_index] ? 3 : 0);
+                std::fill(interpolations.begin() + rotation_start,
+                          interpolations.begin() + rotation_start + 3,
+                          ChannelInterpolation::rotation);
+                rotation_joint_indices.push_back(joint_index);
+            }
+        }
+
+        const Eigen::Index stride = motion_.rows();
+
+        auto resample_chunk = [&](const int chunk_index) -> void
+        {
+            const int frame_begin = chunk_index * internal::resampling_chunk_size;
+            const int size        = std::min(internal::resampling_chunk_size, num_frames - frame_begin);
+
+            const auto indices_0 = source_frames_0.segment(frame_begin, size);
+            const auto indices_1 = source_frames_1.segment(frame_begin, size);
+            const auto weights_1 = weights.segment(frame_begin, size);
+
+            // Interpolate the values of the channels frame-parallel, column by column; the neighboring frames are
+            // gathered explicitly, since indexing by a vector needs Eigen 3.4
+            for (int channel_index = 0; channel_index < num_channels; ++channel_index)
+            {
+                if (interpolations[channel_index] == ChannelInterpolation::rotation)
+                {
+                    continue;
+                }
+
+                const bool    is_angle = interpolations[channel_index] == ChannelInterpolation::angle;
+                const double* column   = motion_.data() + channel_index * stride;
+                double*       output   = resampled.motion_.data() + channel_index * num_frames + frame_begin;
+                for (int i = 0; i < size; ++i)
+                {
+                    const double value_0 = column[indices_0(i)];
+                    double       delta   = column[indices_1(i)] - value_0;
+                    if (is_angle)
+                    {
+                        delta -= 360.0 * std::round(delta / 360.0);
+                    }
+                    output[i] = value_0 + weights_1(i) * delta;
+                }
+            }
+
+            // Interpolate the rotations of the joints by slerp
+            for (const int joint_index : rotation_joint_indices)
+            {
+                const RotationOrder order          = skeleton_->rotation_orders()[joint_index];
+                const int*          axes           = internal::rotation_axes[static_cast<int>(order)];
+                const int           rotation_start = skeleton_->channel_starts()[joint_index] +
+                                                     (skeleton_->has_translation_channels()[joint_index] ? 3 : 0);
+
+                for (int i = 0; i < size; ++i)
+                {
+                    const int    frame_0 = indices_0(i);
+                    const int    frame_1 = indices_1(i);
+                    const double weight  = weights_1(i);
+
+                    const Eigen::Vector3d angles_0 = motion_.block<1, 3>(frame_0, rotation_start).transpose();
+                    if (weight == 0.0)
+                    {
+                        resampled.motion_.block<1, 3>(frame_begin + i, rotation_start) = angles_0.transpose();
+                        continue;
+                    }
+
+                    const double* values_0 = motion_.data() + frame_0;
+                    const double* values_1 = motion_.data() + frame_1;
+
+                    const Eigen::Quaterniond rotation_0 =
+                        has_rotation_cache() ? GetCachedRotations(frame_0)[joint_index]
+                                             : skeleton_->ComputeLocalRotation(joint_index, values_0, stride);
+                    const Eigen::Quaterniond rotation_1 =
+                        has_rotation_cache() ? GetCachedRotations(frame_1)[joint_index]
+                                             : skeleton_->ComputeLocalRotation(joint_index, values_1, stride);
+
+                    // Choose the angles close to the linear interpolation of the original angles
+                    const Eigen::Vector3d angles_1 = motion_.block<1, 3>(frame_1, rotation_start).transpose();
+                    Eigen::Vector3d       reference;
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        reference(axis) =
+                            angles_0(axis) + weight * (internal::unwrap_angle(angles_1(axis), angles_0(axis)) -
+                                                       angles_0(axis));
+                    }
+
+                    const Eigen::Matrix3d rotation = rotation_0.slerp(weight, rotation_1).toRotationMatrix();
+
+                    resampled.motion_.block<1, 3>(frame_begin + i, rotation_start) =
+                        internal::compute_closest_euler_angles(rotation, axes, reference).transpose();
+                }
+            }
+        };
+
+        const int num_chunks = (num_frames + internal::resampling_chunk_size - 1) / internal::resampling_chunk_size;
+        internal::parallel_for(num_chunks, num_threads, resample_chunk);
+
+        return resampled;
+    }
+} // namespace bvh11
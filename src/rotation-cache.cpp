@@ -0,0 +1,68 @@
+#include "parallel-for.hpp"
+#include <algorithm>
+#include <bvh11.hpp>
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+
+namespace bvh11
+{
+    void BvhObject::BuildRotationCache(int num_threads)
+    {
+        const int          num_joints = skeleton_->num_joints();
+        const Eigen::Index stride     = motion_.rows();
+
+        rotation_cache_.resize(static_cast<std::size_t>(frames_) * num_joints);
+
+        constexpr int frames_per_task = 256;
+
+        const int num_tasks = (frames_ + frames_per_task - 1) / frames_per_task;
+
+        auto convert_frames = [&](const int task_index) -> void
+        {
+            const int frame_begin = task_index * frames_per_task;
+            const int frame_end   = std::min(frame_begin + frames_per_task, frames_);
+            for (int frame = frame_begin; frame < frame_end; ++frame)
+            {
+                const double*       values    = motion_.data() + frame;
+                Eigen::Quaterniond* rotations = rotation_cache_.data() + static_cast<std::size_t>(frame) * num_joints;
+                for (int joint_index = 0; joint_index < num_joints; ++joint_index)
+                {
+                    rotations[joint_index] = skeleton_->ComputeLocalRotation(joint_index, values, stride);
+                }
+            }
+        };
+        internal::parallel_for(num_tasks, num_threads, convert_frames);
+    }
+
+    const Eigen::Quaterniond* BvhObject::GetCachedRotations(int frame) const
+    {
+        assert(has_rotation_cache() && "The rotation cache has not been built.");
+        assert(frame < frames() && "Invalid frame is specified.");
+
+        return rotation_cache_.data() + static_cast<std::size_t>(frame) * skeleton_->num_joints();
+    }
+
+    Eigen::Affine3d BvhObject::ComputeLocalTransform(int joint_index, int frame) const
+    {
+        // Static joints have the same transformation at every frame
+        if (has_constant_channel_analysis() && static_joint_flags_[joint_index])
+        {
+            return static_local_transforms_[joint_index];
+        }
+
+        const double*      values = motion_.data() + frame;
+        const Eigen::Index stride = motion_.rows();
+
+        if (!has_rotation_cache())
+        {
+            return skeleton_->ComputeLocalTransform(joint_index, values, stride);
+        }
+
+        Eigen::Affine3d transform;
+        transform.linear()      = GetCachedRotations(frame)[joint_index].toRotationMatrix();
+        transform.translation() = skeleton_->ComputeLocalTranslation(joint_index, values, stride);
+        transform.makeAffine();
+
+        return transform;
+    }
+} // namespace bvh11
@@ -0,0 +1,148 @@
+#ifndef BVH11_ROTATION_KERNELS_HPP_
+#define BVH11_ROTATION_KERNELS_HPP_
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Axis indices of each rotation order (see RotationOrder), listed in the order of the channels.
+        constexpr int rotation_axes[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+        /// \brief Right-multiply a rotation matrix by an elementary rotation around the axis.
+        /// \details An elementary rotation only mixes the two columns other than the axis, so this is done with
+        ///          twelve multiplications instead of a full matrix product.
+        template <int Axis, typename Scalar>
+        inline void apply_axis_rotation(Eigen::Matrix<Scalar, 3, 3>& rotation, Scalar cosine, Scalar sine)
+        {
+            constexpr int i = (Axis + 1) % 3;
+            constexpr int j = (Axis + 2) % 3;
+
+            const Eigen::Matrix<Scalar, 3, 1> column_i = rotation.col(i);
+            const Eigen::Matrix<Scalar, 3, 1> column_j = rotation.col(j);
+
+            rotation.col(i) = cosine * column_i + sine * column_j;
+            rotation.col(j) = cosine * column_j - sine * column_i;
+        }
+
+        /// \brief Set an elementary rotation around the axis.
+        template <int Axis, typename Scalar>
+        inline void set_axis_rotation(Eigen::Matrix<Scalar, 3, 3>& rotation, Scalar cosine, Scalar sine)
+        {
+            constexpr int i = (Axis + 1) % 3;
+            constexpr int j = (Axis + 2) % 3;
+
+            rotation.setZero();
+            rotation(Axis, Axis) = Scalar(1);
+            rotation(i, i)       = cosine;
+            rotation(j, j)       = cosine;
+            rotation(j, i)       = sine;
+            rotation(i, j)       = -sine;
+        }
+
+        /// \brief Compute R_{Axis0}(angle_0) * R_{Axis1}(angle_1) * R_{Axis2}(angle_2) from the angles in degrees.
+        template <int Axis0, int Axis1, int Axis2, typename Scalar>
+        inline Eigen::Matrix<Scalar, 3, 3> compute_euler_rotation(Scalar angle_0, Scalar angle_1, Scalar angle_2)
+        {
+            const Scalar degrees_to_radians = Scalar(M_PI / 180.0);
+
+            angle_0 *= degrees_to_radians;
+            angle_1 *= degrees_to_radians;
+            angle_2 *= degrees_to_radians;
+
+            Eigen::Matrix<Scalar, 3, 3> rotation;
+            set_axis_rotation<Axis0>(rotation, std::cos(angle_0), std::sin(angle_0));
+            apply_axis_rotation<Axis1>(rotation, std::cos(angle_1), std::sin(angle_1));
+            apply_axis_rotation<Axis2>(rotation, std::cos(angle_2), std::sin(angle_2));
+
+            return rotation;
+        }
+
+        /// \brief Return the quaternion of an elementary rotation around the axis.
+        template <int Axis, typename Scalar>
+        inline Eigen::Quaternion<Scalar> make_axis_quaternion(Scalar half_angle)
+        {
+            Eigen::Quaternion<Scalar> quaternion(std::cos(half_angle), Scalar(0), Scalar(0), Scalar(0));
+            quaternion.vec()(Axis) = std::sin(half_angle);
+            return quaternion;
+        }
+
+        /// \brief Quaternion version of compute_euler_rotation, which avoids converting a rotation matrix.
+        template <int Axis0, int Axis1, int Axis2, typename Scalar>
+        inline Eigen::Quaternion<Scalar> compute_euler_quaternion(Scalar angle_0, Scalar angle_1, Scalar angle_2)
+        {
+            const Scalar degrees_to_half_radians = Scalar(M_PI / 360.0);
+
+            return make_axis_quaternion<Axis0>(degrees_to_half_radians * angle_0) *
+                   make_axis_quaternion<Axis1>(degrees_to_half_radians * angle_1) *
+                   make_axis_quaternion<Axis2>(degrees_to_half_radians * angle_2);
+        }
+
+        /// \brief Shift the angle in degrees by a multiple of 360 degrees so that it is the closest to the reference.
+        inline double unwrap_angle(double angle, double reference)
+        {
+            // Most angles are already within half a turn, which needs no rounding
+            const double difference = angle - reference;
+            return std::abs(difference) <= 180.0 ? angle : angle - 360.0 * std::round(difference / 360.0);
+        }
+
+        /// \brief Convert a rotation matrix to the Euler angles in degrees (see compute_euler_rotation) that are the
+        ///        closest to the reference angles.
+        /// \details Either of the two sets of the angles that represent the rotation is chosen, and each angle is
+        ///          shifted by a multiple of 360 degrees, so that a sequence of rotations does not jump by wrapping
+        ///          around.
+        /// \param axes Axis indices of the channels (see rotation_axes).
+        inline Eigen::Vector3d compute_closest_euler_angles(const Eigen::Matrix3d& rotation,
+                                                            const int*             axes,
+                                                            const Eigen::Vector3d& reference)
+        {
+            const int i = axes[0];
+            const int j = axes[1];
+            const int k = axes[2];
+
+            // For R = R_i(a) R_j(b) R_k(c), R(i, k) = sign * sin(b), where the sign depends on the parity of the axes
+            const double sign = (j == (i + 1) % 3) ? 1.0 : -1.0;
+            const double sine = sign * rotation(i, k);
+
+            Eigen::Vector3d angles;
+            if (std::abs(sine) < 1.0 - 1e-12)
+            {
+                angles(0) = std::atan2(-sign * rotation(j, k), rotation(k, k));
+                angles(1) = std::asin(sine);
+                angles(2) = std::atan2(-sign * rotation(i, j), rotation(i, i));
+                angles *= 180.0 / M_PI;
+            }
+            else
+            {
+                // Only the sum or the difference of the first and the last angles is determined at the gimbal lock
+                angles = (180.0 / M_PI) * rotation.eulerAngles(i, j, k);
+            }
+
+            auto unwrap_angles = [&](const Eigen::Vector3d& candidate) -> Eigen::Vector3d
+            {
+                return Eigen::Vector3d(unwrap_angle(candidate(0), reference(0)),
+                                       unwrap_angle(candidate(1), reference(1)),
+                                       unwrap_angle(candidate(2), reference(2)));
+            };
+
+            // The other set differs by half a turn in the first angle, so it cannot be closer than this set when this
+            // set is within a quarter turn in total
+            const Eigen::Vector3d candidate_0 = unwrap_angles(angles);
+            if ((candidate_0 - reference).squaredNorm() < 90.0 * 90.0)
+            {
+                return candidate_0;
+            }
+
+            const Eigen::Vector3d candidate_1 =
+                unwrap_angles(Eigen::Vector3d(angles(0) + 180.0, 180.0 - angles(1), angles(2) + 180.0));
+
+            return ((candidate_0 - reference).squaredNorm() <= (candidate_1 - reference).squaredNorm()) ? candidate_0
+                                                                                                         : candidate_1;
+        }
+    } // namespace internal
+} // namespace bvh11
+
+#endif
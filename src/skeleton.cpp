@@ -0,0 +1,310 @@
+#include "rotation-kernels.hpp"
+#include <bvh11/skeleton.hpp>
+#include <cassert>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \return The axis index of a rotation channel, or -1 for a translation channel.
+        inline int get_rotation_axis(const Channel::Type type)
+        {
+            switch (type)
+            {
+                case Channel::Type::x_rotation:
+                    return 0;
+                case Channel::Type::y_rotation:
+                    return 1;
+                case Channel::Type::z_rotation:
+                    return 2;
+                default:
+                    return -1;
+            }
+        }
+
+        inline RotationOrder classify_rotation_channels(const Channel::Type* types)
+        {
+            const int axes[3] = {get_rotation_axis(types[0]), get_rotation_axis(types[1]), get_rotation_axis(types[2])};
+            for (int order = 0; order < 6; ++order)
+            {
+                if (axes[0] == rotation_axes[order][0] && axes[1] == rotation_axes[order][1] &&
+                    axes[2] == rotation_axes[order][2])
+                {
+                    return static_cast<RotationOrder>(order);
+                }
+            }
+            return RotationOrder::generic;
+        }
+
+        inline bool is_standard_translation(const Channel::Type* types)
+        {
+            return types[0] == Channel::Type::x_position && types[1] == Channel::Type::y_position &&
+                   types[2] == Channel::Type::z_position;
+        }
+    } // namespace internal
+
+    Skeleton::Skeleton(const BvhObject& bvh)
+        : parent_indices_(bvh.parent_indices()),
+          offsets_(3, bvh.parent_indices().size()),
+          end_sites_(3, bvh.parent_indices().size())
+    {
+        const std::vector<std::shared_ptr<const Joint>> joints = bvh.GetJointList();
+
+        for (const Channel& channel : bvh.channels())
+        {
+            channel_types_.push_back(channel.type);
+        }
+
+        for (int joint_index = 0; joint_index < num_joints(); ++joint_index)
+        {
+            const std::shared_ptr<const Joint>& joint = joints[joint_index];
+
+            names_.push_back(joint->name());
+            offsets_.col(joint_index)   = joint->offset();
+            end_sites_.col(joint_index) = joint->has_end_site() ? joint->end_site() : Eigen::Vector3d::Zero();
+            has_end_sites_.push_back(joint->has_end_site());
+
+            // Channels of a joint are always declared in a single line, so their indices are consecutive
+            const auto& indices = joint->associated_channels_indices();
+            const int   start   = indices.empty() ? 0 : indices.front();
+            const int   count   = static_cast<int>(indices.size());
+            assert(indices.empty() || indices.back() == start + count - 1);
+
+            channel_starts_.push_back(start);
+            channel_counts_.push_back(count);
+
+            // Classify the channel layout once so that the evaluation does not need to look at the types
+            const Channel::Type* types = channel_types_.data() + start;
+            if (count == 0)
+            {
+                rotation_orders_.push_back(RotationOrder::none);
+                has_translation_channels_.push_back(false);
+            }
+            else if (count == 3)
+            {
+                rotation_orders_.push_back(internal::classify_rotation_channels(types));
+                has_translation_channels_.push_back(false);
+            }
+            else if (count == 6 && internal::is_standard_translation(types))
+            {
+                rotation_orders_.push_back(internal::classify_rotation_channels(types + 3));
+                has_translation_channels_.push_back(true);
+            }
+            else
+            {
+                rotation_orders_.push_back(RotationOrder::generic);
+                has_translation_channels_.push_back(count == 6);
+            }
+        }
+    }
+
+    int Skeleton::FindJoint(const std::string& name) const
+    {
+        for (int joint_index = 0; joint_index < num_joints(); ++joint_index)
+        {
+            if (names_[joint_index] == name)
+            {
+                return joint_index;
+            }
+        }
+        return -1;
+    }
+
+    bool Skeleton::IsEquivalent(const Skeleton& other) const
+    {
+        // The rotation orders and the translation flags are derived from the channels, so they need no comparison
+        return parent_indices_ == other.parent_indices_ && channel_types_ == other.channel_types_ &&
+               channel_starts_ == other.channel_starts_ && channel_counts_ == other.channel_counts_ &&
+               has_end_sites_ == other.has_end_sites_ && offsets_ == other.offsets_ &&
+               end_sites_ == other.end_sites_ && names_ == other.names_;
+    }
+
+    Eigen::Affine3d Skeleton::ComputeLocalTransform(int joint_index, const double* values, Eigen::Index stride) const
+    {
+        const RotationOrder order = rotation_orders_[joint_index];
+        if (order == RotationOrder::generic)
+        {
+            return ComputeGenericLocalTransform(joint_index, values, stride);
+        }
+
+        const double* channel_values = values + channel_starts_[joint_index] * stride;
+
+        Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+
+        // Apply either time-varying translation or intrinsic offset translation
+        if (has_translation_channels_[joint_index])
+        {
+            transform.translation() << channel_values[0], channel_values[stride], channel_values[2 * stride];
+            channel_values += 3 * stride;
+        }
+        else
+        {
+            transform.translation() = offsets_.col(joint_index);
+        }
+
+        if (order == RotationOrder::none)
+        {
+            return transform;
+        }
+
+        // Apply time-varying rotation using the kernel specialized for the rotation order
+        const double angle_0 = channel_values[0];
+        const double angle_1 = channel_values[stride];
+        const double angle_2 = channel_values[2 * stride];
+        switch (order)
+        {
+            case RotationOrder::xyz:
+                transform.linear() = internal::compute_euler_rotation<0, 1, 2>(angle_0, angle_1, angle_2);
+                break;
+            case RotationOrder::xzy:
+                transform.linear() = internal::compute_euler_rotation<0, 2, 1>(angle_0, angle_1, angle_2);
+                break;
+            case RotationOrder::yxz:
+                transform.linear() = internal::compute_euler_rotation<1, 0, 2>(angle_0, angle_1, angle_2);
+                break;
+            case RotationOrder::yzx:
+                transform.linear() = internal::compute_euler_rotation<1, 2, 0>(angle_0, angle_1, angle_2);
+                break;
+            case RotationOrder::zxy:
+                transform.linear() = internal::compute_euler_rotation<2, 0, 1>(angle_0, angle_1, angle_2);
+                break;
+            case RotationOrder::zyx:
+                transform.linear() = internal::compute_euler_rotation<2, 1, 0>(angle_0, angle_1, angle_2);
+                break;
+            case RotationOrder::none:
+            case RotationOrder::generic:
+                break;
+        }
+
+        return transform;
+    }
+
+    Eigen::Quaterniond Skeleton::ComputeLocalRotation(int joint_index, const double* values, Eigen::Index stride) const
+    {
+        const RotationOrder order = rotation_orders_[joint_index];
+        if (order == RotationOrder::generic)
+        {
+            return Eigen::Quaterniond(ComputeGenericLocalTransform(joint_index, values, stride).linear());
+        }
+
+        const int     rotation_start = channel_starts_[joint_index] + (has_translation_channels_[joint_index] ? 3 : 0);
+        const double* channel_values = values + rotation_start * stride;
+
+        switch (order)
+        {
+            case RotationOrder::xyz:
+                return internal::compute_euler_quaternion<0, 1, 2>(
+                    channel_values[0], channel_values[stride], channel_values[2 * stride]);
+            case RotationOrder::xzy:
+                return internal::compute_euler_quaternion<0, 2, 1>(
+                    channel_values[0], channel_values[stride], channel_values[2 * stride]);
+            case RotationOrder::yxz:
+                return internal::compute_euler_quaternion<1, 0, 2>(
+                    channel_values[0], channel_values[stride], channel_values[2 * stride]);
+            case RotationOrder::yzx:
+                return internal::compute_euler_quaternion<1, 2, 0>(
+                    channel_values[0], channel_values[stride], channel_values[2 * stride]);
+            case RotationOrder::zxy:
+                return internal::compute_euler_quaternion<2, 0, 1>(
+                    channel_values[0], channel_values[stride], channel_values[2 * stride]);
+            case RotationOrder::zyx:
+                return internal::compute_euler_quaternion<2, 1, 0>(
+                    channel_values[0], channel_values[stride], channel_values[2 * stride]);
+            case RotationOrder::none:
+            case RotationOrder::generic:
+                break;
+        }
+
+        return Eigen::Quaterniond::Identity();
+    }
+
+    Eigen::Vector3d Skeleton::ComputeLocalTranslation(int joint_index, const double* values, Eigen::Index stride) const
+    {
+        if (rotation_orders_[joint_index] == RotationOrder::generic)
+        {
+            return ComputeGenericLocalTransform(joint_index, values, stride).translation();
+        }
+        if (has_translation_channels_[joint_index])
+        {
+            const double* channel_values = values + channel_starts_[joint_index] * stride;
+            return Eigen::Vector3d(channel_values[0], channel_values[stride], channel_values[2 * stride]);
+        }
+        return offsets_.col(joint_index);
+    }
+
+    Eigen::Affine3d
+    Skeleton::ComputeGenericLocalTransform(int joint_index, const double* values, Eigen::Index stride) const
+    {
+        const bool has_time_varying_translation = has_translation_channels_[joint_index];
+
+        // Apply intrinsic offset translation unless it is replaced by time-varying translation
+        Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+        if (!has_time_varying_translation)
+        {
+            transform *= Eigen::Translation3d(offsets_.col(joint_index));
+        }
+
+        // Apply time-varying transformations
+        const int channel_start = channel_starts_[joint_index];
+        const int channel_end   = channel_start + channel_counts_[joint_index];
+        for (int channel_index = channel_start; channel_index < channel_end; ++channel_index)
+        {
+            const double value = values[channel_index * stride];
+
+            switch (channel_types_[channel_index])
+            {
+                case Channel::Type::x_position:
+                    assert(has_time_varying_translation && "Found an invalid channel configuration");
+                    transform *= Eigen::Translation3d(Eigen::Vector3d(value, 0.0, 0.0));
+                    break;
+                case Channel::Type::y_position:
+                    assert(has_time_varying_translation && "Found an invalid channel configuration");
+                    transform *= Eigen::Translation3d(Eigen::Vector3d(0.0, value, 0.0));
+                    break;
+                case Channel::Type::z_position:
+                    assert(has_time_varying_translation && "Found an invalid channel configuration");
+                    transform *= Eigen::Translation3d(Eigen::Vector3d(0.0, 0.0, value));
+                    break;
+                case Channel::Type::x_rotation:
+                    transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitX());
+                    break;
+                case Channel::Type::y_rotation:
+                    transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitY());
+                    break;
+                case Channel::Type::z_rotation:
+                    transform *= Eigen::AngleAxisd(value * M_PI / 180.0, Eigen::Vector3d::UnitZ());
+                    break;
+            }
+        }
+
+        return transform;
+    }
+
+    void Skeleton::ComputeGlobalTransforms(const Eigen::MatrixXd& motion, int frame, Eigen::Affine3d* transforms) const
+    {
+        assert(frame < motion.rows() && "Invalid frame is specified.");
+        assert(motion.cols() == num_channels() && "The motion does not match the skeleton.");
+
+        const double*      values = motion.data() + frame;
+        const Eigen::Index stride = motion.rows();
+
+        for (int joint_index = 0; joint_index < num_joints(); ++joint_index)
+        {
+            const int parent_index = parent_indices_[joint_index];
+            if (parent_index < 0)
+            {
+                transforms[joint_index] = ComputeLocalTransform(joint_index, values, stride);
+            }
+            else
+            {
+                transforms[joint_index] = transforms[parent_index] * ComputeLocalTransform(joint_index, values, stride);
+            }
+        }
+    }
+
+    void Skeleton::ComputeGlobalTransforms(const Eigen::MatrixXd& motion, int frame, TransformList& transforms) const
+    {
+        transforms.resize(num_joints());
+        ComputeGlobalTransforms(motion, frame, transforms.data());
+    }
+} // namespace bvh11
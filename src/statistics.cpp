@@ -0,0 +1,53 @@
+#include "statistics.hpp"
+
+namespace bvh11
+{
+    namespace internal
+    {
+#ifdef BVH11_ENABLE_STATISTICS
+        thread_local std::uint64_t allocation_count = 0;
+#endif
+
+        std::uint64_t get_thread_allocation_count()
+        {
+#ifdef BVH11_ENABLE_STATISTICS
+            return allocation_count;
+#else
+            return 0;
+#endif
+        }
+
+        KinematicsStatistics& get_thread_kinematics_statistics()
+        {
+            thread_local KinematicsStatistics statistics;
+            return statistics;
+        }
+    } // namespace internal
+
+    LoadStatistics& LoadStatistics::operator+=(const LoadStatistics& other)
+    {
+        num_files += other.num_files;
+        num_bytes += other.num_bytes;
+        num_lines += other.num_lines;
+        num_tokens += other.num_tokens;
+        num_allocations += other.num_allocations;
+        hierarchy_seconds += other.hierarchy_seconds;
+        motion_seconds += other.motion_seconds;
+        scaling_seconds += other.scaling_seconds;
+        flattening_seconds += other.flattening_seconds;
+        total_seconds += other.total_seconds;
+
+        return *this;
+    }
+
+    KinematicsStatistics GetKinematicsStatistics() { return internal::get_thread_kinematics_statistics(); }
+
+    void ResetKinematicsStatistics() { internal::get_thread_kinematics_statistics() = KinematicsStatistics(); }
+
+    void CountAllocation() noexcept
+    {
+#ifdef BVH11_ENABLE_STATISTICS
+        ++internal::allocation_count;
+#endif
+    }
+} // namespace bvh11
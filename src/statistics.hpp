@@ -0,0 +1,96 @@
+#ifndef BVH11_INTERNAL_STATISTICS_HPP_
+#define BVH11_INTERNAL_STATISTICS_HPP_
+
+#include <bvh11/statistics.hpp>
+#include <chrono>
+#include <cstdint>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \return The number of the heap allocations made by this thread so far, or zero without the statistics.
+        std::uint64_t get_thread_allocation_count();
+
+        KinematicsStatistics& get_thread_kinematics_statistics();
+
+        /// \brief Return the statistics to be recorded, which is always null without the statistics so that the
+        ///        compiler removes every use of it.
+        inline LoadStatistics* resolve_statistics(LoadStatistics* statistics)
+        {
+            return is_statistics_enabled() ? statistics : nullptr;
+        }
+
+        /// \brief Add the elapsed time of the scope to the target unless it is null.
+        class ScopedTimer
+        {
+        public:
+            explicit ScopedTimer(double* seconds) : seconds_(is_statistics_enabled() ? seconds : nullptr)
+            {
+                if (seconds_ != nullptr)
+                {
+                    begin_ = std::chrono::steady_clock::now();
+                }
+            }
+
+            ~ScopedTimer()
+            {
+                if (seconds_ != nullptr)
+                {
+                    *seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_).count();
+                }
+            }
+
+            ScopedTimer(const ScopedTimer&)            = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        private:
+            double*                               seconds_;
+            std::chrono::steady_clock::time_point begin_;
+        };
+
+        /// \brief Record a call of forward kinematics to the statistics of this thread when the statistics are enabled.
+        class KinematicsRecorder
+        {
+        public:
+            explicit KinematicsRecorder(std::uint64_t num_local_transforms = 0)
+                : num_local_transforms_(num_local_transforms)
+            {
+                if (is_statistics_enabled())
+                {
+                    begin_ = std::chrono::steady_clock::now();
+                }
+            }
+
+            ~KinematicsRecorder()
+            {
+                if (is_statistics_enabled())
+                {
+                    const auto end = std::chrono::steady_clock::now();
+
+                    KinematicsStatistics& statistics = get_thread_kinematics_statistics();
+                    statistics.num_calls += 1;
+                    statistics.num_local_transforms += num_local_transforms_;
+                    statistics.seconds += std::chrono::duration<double>(end - begin_).count();
+                }
+            }
+
+            KinematicsRecorder(const KinematicsRecorder&)            = delete;
+            KinematicsRecorder& operator=(const KinematicsRecorder&) = delete;
+
+            void AddLocalTransforms(std::uint64_t num_local_transforms)
+            {
+                if (is_statistics_enabled())
+                {
+                    num_local_transforms_ += num_local_transforms;
+                }
+            }
+
+        private:
+            std::uint64_t                         num_local_transforms_;
+            std::chrono::steady_clock::time_point begin_;
+        };
+    } // namespace internal
+} // namespace bvh11
+
+#endif
@@ -0,0 +1,169 @@
+#include "parser.hpp"
+#include <algorithm>
+#include <bvh11/stream-reader.hpp>
+#include <cassert>
+#include <stdexcept>
+
+namespace bvh11
+{
+    BvhStreamReader::BvhStreamReader(const std::string& file_path, const StreamReaderOptions& options)
+        : options_(options), ifs_(file_path, std::ios::binary)
+    {
+        if (options_.index_interval < 1)
+        {
+            throw std::invalid_argument("The index interval must be positive.");
+        }
+        if (!ifs_.is_open())
+        {
+            throw std::runtime_error("Failed to open the input file.");
+        }
+
+        // Read the HIERARCHY part and the header of the MOTION part eagerly
+        internal::StreamLineReader reader(ifs_);
+        internal::read_hierarchy(reader, options_.scale, root_joint_, channels_);
+        internal::read_motion_header(reader, frames_, frame_time_);
+        num_header_lines_ = reader.line_number();
+
+        // Record the positions of the frame lines instead of reading them
+        IndexFrames();
+    }
+
+    Eigen::VectorXd BvhStreamReader::GetFrame(int frame)
+    {
+        assert(frame >= 0 && frame < frames() && "Invalid frame is specified.");
+
+        const int interval = options_.index_interval;
+        return GetBlock(frame / interval).row(frame % interval).transpose();
+    }
+
+    Eigen::MatrixXd BvhStreamReader::ReadFrameRange(int frame_begin, int frame_end)
+    {
+        assert(0 <= frame_begin && frame_begin <= frame_end && frame_end <= frames() && "Invalid range is specified.");
+
+        const int interval = options_.index_interval;
+
+        Eigen::MatrixXd motion(frame_end - frame_begin, channels_.size());
+
+        int frame = frame_begin;
+        while (frame < frame_end)
+        {
+            const Eigen::MatrixXd& block = GetBlock(frame / interval);
+
+            const int row_begin = frame % interval;
+            const int num_rows  = std::min(static_cast<int>(block.rows()) - row_begin, frame_end - frame);
+
+            motion.middleRows(frame - frame_begin, num_rows) = block.middleRows(row_begin, num_rows);
+
+            frame += num_rows;
+        }
+
+        return motion;
+    }
+
+    void BvhStreamReader::IndexFrames()
+    {
+        constexpr std::size_t chunk_size = 1 << 20;
+
+        const int interval = options_.index_interval;
+
+        std::int64_t chunk_offset = static_cast<std::int64_t>(ifs_.tellg());
+        std::int64_t line_offset  = chunk_offset;
+
+        block_offsets_.clear();
+        if (frames_ > 0)
+        {
+            block_offsets_.push_back(line_offset);
+        }
+
+        // Scan the remaining part chunk by chunk and find the beginnings of the frame lines
+        int               num_lines = 0;
+        std::vector<char> chunk(chunk_size);
+        while (num_lines < frames_)
+        {
+            ifs_.read(chunk.data(), chunk.size());
+            const std::size_t num_read = static_cast<std::size_t>(ifs_.gcount());
+            if (num_read == 0)
+            {
+                break;
+            }
+
+            for (std::size_t i = 0; i < num_read && num_lines < frames_; ++i)
+            {
+                if (chunk[i] != '\n')
+                {
+                    continue;
+                }
+
+                ++num_lines;
+                line_offset = chunk_offset + static_cast<std::int64_t>(i) + 1;
+
+                if (num_lines == frames_ || num_lines % interval == 0)
+                {
+                    block_offsets_.push_back(line_offset);
+                }
+            }
+
+            chunk_offset += static_cast<std::int64_t>(num_read);
+        }
+
+        // The last frame line may not be terminated by a new-line character
+        if (num_lines < frames_ && chunk_offset > line_offset)
+        {
+            ++num_lines;
+            block_offsets_.push_back(chunk_offset);
+        }
+        if (num_lines < frames_)
+        {
+            internal::throw_parse_error(num_header_lines_ + num_lines + 1, "Found an unexpected end of the file");
+        }
+
+        ifs_.clear();
+    }
+
+    const Eigen::MatrixXd& BvhStreamReader::GetBlock(int block_index)
+    {
+        // Move the block to the front if it is already decoded
+        const auto cached_block = cache_table_.find(block_index);
+        if (cached_block != cache_table_.end())
+        {
+            cached_blocks_.splice(cached_blocks_.begin(), cached_blocks_, cached_block->second);
+            return cached_block->second->second;
+        }
+
+        const int interval    = options_.index_interval;
+        const int frame_begin = block_index * interval;
+        const int frame_end   = std::min(frame_begin + interval, frames_);
+
+        // Read the lines of the block at once
+        const std::int64_t byte_begin = block_offsets_[block_index];
+        const std::int64_t byte_end   = block_offsets_[block_index + 1];
+
+        buffer_.resize(static_cast<std::size_t>(byte_end - byte_begin));
+        ifs_.seekg(byte_begin);
+        ifs_.read(&buffer_[0], buffer_.size());
+        assert(ifs_.gcount() == static_cast<std::streamsize>(buffer_.size()) && "Failed to read frames");
+
+        // Decode the block
+        Eigen::MatrixXd block(frame_end - frame_begin, channels_.size());
+
+        const char*                begin = buffer_.data();
+        internal::MemoryLineReader reader(begin, begin + buffer_.size(), num_header_lines_ + frame_begin);
+        internal::read_frames(reader, block);
+        internal::scale_translations(channels_, options_.scale, block);
+
+        // Evict the least recently used blocks to keep the cache within the capacity
+        const int max_num_blocks = std::max(1, options_.cache_capacity / interval);
+        while (static_cast<int>(cached_blocks_.size()) >= max_num_blocks)
+        {
+            num_cached_frames_ -= static_cast<int>(cached_blocks_.back().second.rows());
+            cache_table_.erase(cached_blocks_.back().first);
+            cached_blocks_.pop_back();
+        }
+
+        num_cached_frames_ += static_cast<int>(block.rows());
+        cached_blocks_.emplace_front(block_index, std::move(block));
+        cache_table_[block_index] = cached_blocks_.begin();
+
+        return cached_blocks_.front().second;
+    }
+} // namespace bvh11
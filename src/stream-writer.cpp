@@ -0,0 +1,249 @@
+#include "formatter.hpp"
+#include <algorithm>
+#include <bvh11/stream-writer.hpp>
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Width of the placeholder of the number of the frames, which fits any int.
+        constexpr int frames_field_width = 10;
+
+        /// \brief Size of the formatted text accumulated by the background thread before it is written.
+        constexpr std::size_t stream_writer_buffer_size = 1 << 20;
+
+        /// \brief Maximum time for which the background thread sleeps without being notified.
+        constexpr std::chrono::milliseconds stream_writer_wait_timeout(10);
+    } // namespace internal
+
+    BvhStreamWriter::BvhStreamWriter(const std::string&         file_path,
+                                     const BvhObject&           bvh_object,
+                                     const StreamWriterOptions& options)
+        : ofs_(file_path, std::ios::binary),
+          frames_offset_(0),
+          write_options_(options.write_options),
+          num_channels_(static_cast<int>(bvh_object.channels().size())),
+          capacity_(static_cast<std::uint64_t>(std::max(1, options.queue_capacity))),
+          slots_(capacity_ * num_channels_),
+          head_(0),
+          tail_(0),
+          cached_head_(0),
+          has_failed_(false),
+          is_closing_(false),
+          is_writer_waiting_(false)
+    {
+        if (!ofs_.is_open())
+        {
+            throw std::runtime_error("Failed to open the output file.");
+        }
+        assert(write_options_.decimal_places >= 0 && "Invalid number of decimal places is specified.");
+        assert(write_options_.decimal_places >= 0 && "Invalid number of decimal places is specified.");
+
+        // Hierarchy
+        std::string header = "HIERARCHY\n";
+        internal::append_joint_sub_hierarchy(header, bvh_object.root_joint(), bvh_object.channels(), 0, write_options_);
+
+        // Motion, where the number of the frames is zero until it is patched so that the file is valid meanwhile
+        header += "MOTION\n";
+        header += "Frames: ";
+        frames_offset_ = static_cast<std::streamoff>(header.size());
+        header += '0';
+        header.append(internal::frames_field_width - 1, ' ');
+        header += "\nFrame Time: ";
+        internal::append_double(header, bvh_object.frame_time(), write_options_);
+        header += '\n';
+
+        ofs_.write(header.data(), header.size());
+        ofs_.flush();
+
+        writer_thread_ = std::thread(&BvhStreamWriter::WriteFrames, this);
+    }
+
+    BvhStreamWriter::~BvhStreamWriter()
+    {
+        if (is_open())
+        {
+            // Destructors must not throw; call Close explicitly to find out whether the file was written
+            try
+            {
+                Close();
+            }
+            catch (const std::runtime_error&)
+            {
+            }
+        }
+    }
+
+    void BvhStreamWriter::AppendFrame(const double* values)
+    {
+        assert(is_open() && "The writer is already closed.");
+
+        // Wait for the background thread to free a slot; it does not take the lock for this, so yielding suffices
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        while (tail - cached_head_ == capacity_)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == capacity_)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        std::copy(values, values + num_channels_, slots_.data() + (tail % capacity_) * num_channels_);
+
+        // Publish the frame; this store and the load in Notify are sequentially consistent so that either the
+        // background thread sees the frame before sleeping or this thread sees that it is sleeping
+        tail_.store(tail + 1);
+        Notify();
+    }
+
+    void BvhStreamWriter::AppendFrame(const Eigen::VectorXd& values)
+    {
+        assert(values.size() == num_channels_ && "The number of the values does not match the channels.");
+
+        AppendFrame(values.data());
+    }
+
+    bool BvhStreamWriter::TryAppendFrame(const Eigen::VectorXd& values)
+    {
+        assert(values.size() == num_channels_ && "The number of the values does not match the channels.");
+
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == capacity_)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == capacity_)
+            {
+                return false;
+            }
+        }
+
+        AppendFrame(values.data());
+        return true;
+    }
+
+    void BvhStreamWriter::AppendFrames(const Eigen::MatrixXd& frames)
+    {
+        assert(frames.cols() == num_channels_ && "The number of the columns does not match the channels.");
+
+        // Rows of a column-major matrix are strided, so each row is gathered before being copied into the queue
+        Eigen::VectorXd values(num_channels_);
+        for (Eigen::Index frame = 0; frame < frames.rows(); ++frame)
+        {
+            values = frames.row(frame).transpose();
+            AppendFrame(values.data());
+        }
+    }
+
+    void BvhStreamWriter::Close()
+    {
+        assert(is_open() && "The writer is already closed.");
+
+        is_closing_.store(true);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_one();
+        }
+        writer_thread_.join();
+
+        // Patch the number of the frames
+        std::string frames_field = std::to_string(tail_.load());
+        assert(frames_field.size() <= static_cast<std::size_t>(internal::frames_field_width));
+        frames_field.resize(internal::frames_field_width, ' ');
+
+        ofs_.seekp(frames_offset_);
+        ofs_.write(frames_field.data(), frames_field.size());
+        ofs_.close();
+
+        // The stream stays failed once an operation fails, so this also covers the header and the patch above
+        if (has_failed_.load() || ofs_.fail())
+        {
+            throw std::runtime_error("Failed to write the output file.");
+        }
+    }
+
+    void BvhStreamWriter::Notify()
+    {
+        if (is_writer_waiting_.load())
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_one();
+        }
+    }
+
+    void BvhStreamWriter::WriteFrames()
+    {
+        std::string buffer;
+        buffer.reserve(internal::stream_writer_buffer_size + 64 * num_channels_);
+
+        auto write_buffer = [&]() -> void
+        {
+            ofs_.write(buffer.data(), buffer.size());
+            buffer.clear();
+        };
+
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const std::uint64_t tail = tail_.load(std::memory_order_acquire);
+
+            // Format the queued frames, releasing each slot as soon as it is formatted
+            for (; head != tail; ++head)
+            {
+                const double* values = slots_.data() + (head % capacity_) * num_channels_;
+                for (int channel_index = 0; channel_index < num_channels_; ++channel_index)
+                {
+                    if (channel_index != 0)
+                    {
+                        buffer += ' ';
+                    }
+                    internal::append_double(buffer, values[channel_index], write_options_);
+                }
+                buffer += '\n';
+
+                head_.store(head + 1, std::memory_order_release);
+
+                if (buffer.size() >= internal::stream_writer_buffer_size)
+                {
+                    write_buffer();
+                }
+            }
+
+            // Check for new frames before going idle; the closing flag is set after the last frame is appended
+            if (tail_.load(std::memory_order_acquire) != head)
+            {
+                continue;
+            }
+
+            write_buffer();
+            ofs_.flush();
+
+            // Keep consuming the frames after a failure so that the appending thread is never blocked by a full
+            // queue; the writes of a failed stream do nothing
+            if (ofs_.fail())
+            {
+                has_failed_.store(true);
+            }
+
+            if (is_closing_.load())
+            {
+                if (tail_.load(std::memory_order_acquire) == head)
+                {
+                    return;
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            is_writer_waiting_.store(true);
+            if (tail_.load() == head && !is_closing_.load())
+            {
+                condition_.wait_for(lock, internal::stream_writer_wait_timeout);
+            }
+            is_writer_waiting_.store(false);
+        }
+    }
+} // namespace bvh11
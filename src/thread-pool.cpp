@@ -0,0 +1,140 @@
+#include "thread-pool.hpp"
+#include "parallel-for.hpp"
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        ThreadPool::ThreadPool(int num_threads) : next_task_index_(0)
+        {
+            const int num_workers = resolve_num_threads(num_threads) - 1;
+
+            workers_.reserve(num_workers);
+            for (int i = 0; i < num_workers; ++i)
+            {
+                workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                is_stopping_ = true;
+            }
+            work_condition_.notify_all();
+
+            for (std::thread& worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        void ThreadPool::Run(int num_tasks, const std::function<void(int)>& function)
+        {
+            std::lock_guard<std::mutex> run_lock(run_mutex_);
+
+            if (workers_.empty() || num_tasks <= 1)
+            {
+                for (int task_index = 0; task_index < num_tasks; ++task_index)
+                {
+                    function(task_index);
+                }
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                function_         = &function;
+                num_tasks_        = num_tasks;
+                num_busy_workers_ = static_cast<int>(workers_.size());
+                next_task_index_  = 0;
+                ++generation_;
+            }
+            work_condition_.notify_all();
+
+            Work();
+
+            std::exception_ptr exception;
+            {
+                // The function must stay alive until every worker has left the current run
+                std::unique_lock<std::mutex> lock(mutex_);
+                done_condition_.wait(lock, [&]() -> bool { return num_busy_workers_ == 0; });
+                function_ = nullptr;
+                std::swap(exception, exception_);
+            }
+
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        void ThreadPool::WorkerLoop()
+        {
+            std::uint64_t last_generation = 0;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    work_condition_.wait(lock,
+                                         [&]() -> bool { return is_stopping_ || generation_ != last_generation; });
+                    if (is_stopping_)
+                    {
+                        return;
+                    }
+                    last_generation = generation_;
+                }
+
+                Work();
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--num_busy_workers_ == 0)
+                {
+                    done_condition_.notify_one();
+                }
+            }
+        }
+
+        void ThreadPool::Work()
+        {
+            try
+            {
+                for (int task_index = next_task_index_++; task_index < num_tasks_; task_index = next_task_index_++)
+                {
+                    (*function_)(task_index);
+                }
+            }
+            catch (...)
+            {
+                // Skip the remaining tasks, since the result is discarded anyway
+                next_task_index_ = num_tasks_;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!exception_)
+                {
+                    exception_ = std::current_exception();
+                }
+            }
+        }
+
+        ThreadPool& get_shared_thread_pool(int num_threads)
+        {
+            static std::mutex                                 mutex;
+            static std::map<int, std::unique_ptr<ThreadPool>> pools;
+
+            const int resolved_num_threads = resolve_num_threads(num_threads);
+
+            std::lock_guard<std::mutex>  lock(mutex);
+            std::unique_ptr<ThreadPool>& pool = pools[resolved_num_threads];
+            if (pool == nullptr)
+            {
+                pool.reset(new ThreadPool(resolved_num_threads));
+            }
+            return *pool;
+        }
+    } // namespace internal
+} // namespace bvh11
@@ -0,0 +1,72 @@
+#ifndef BVH11_THREAD_POOL_HPP_
+#define BVH11_THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bvh11
+{
+    namespace internal
+    {
+        /// \brief Persistent worker threads for running many short parallel loops.
+        /// \details Unlike parallel_for, which starts and joins its threads on every call, the workers are started
+        ///          once at construction and wait on a condition variable between runs, so a run only costs a wake-up
+        ///          of the workers. Tasks are distributed dynamically through a shared atomic counter, and the calling
+        ///          thread also works as one of the workers. Runs on the same pool are serialized.
+        class ThreadPool
+        {
+        public:
+            /// \param num_threads Total number of threads including the calling thread; zero means the number of
+            ///                    hardware threads.
+            explicit ThreadPool(int num_threads);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&)            = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            int num_threads() const { return static_cast<int>(workers_.size()) + 1; }
+
+            /// \brief Call the function for every task index in [0, num_tasks) and wait for all of them.
+            /// \details If a task throws an exception, the workers stop taking new tasks, and the first exception is
+            ///          rethrown on the calling thread after all the workers have finished.
+            void Run(int num_tasks, const std::function<void(int)>& function);
+
+        private:
+            void WorkerLoop();
+            void Work();
+
+            std::vector<std::thread> workers_;
+
+            /// \brief Serializes the runs.
+            std::mutex run_mutex_;
+
+            /// \brief Protects the state of the current run below, except for the task counter.
+            std::mutex              mutex_;
+            std::condition_variable work_condition_;
+            std::condition_variable done_condition_;
+
+            const std::function<void(int)>* function_         = nullptr;
+            int                             num_tasks_        = 0;
+            int                             num_busy_workers_ = 0;
+            std::uint64_t                   generation_       = 0;
+            bool                            is_stopping_      = false;
+            std::exception_ptr              exception_;
+
+            std::atomic<int> next_task_index_;
+        };
+
+        /// \brief Return a process-wide pool with the number of threads, which is created on the first use and reused
+        ///        by every later call (e.g., per-frame queries that cannot own a pool).
+        /// \details Runs on a pool are serialized, so concurrent callers of the same number of threads wait for each
+        ///          other.
+        ThreadPool& get_shared_thread_pool(int num_threads);
+    } // namespace internal
+} // namespace bvh11
+
+#endif
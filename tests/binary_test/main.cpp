@@ -0,0 +1,77 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    bool has_same_data(const bvh11::BvhObject& a, const bvh11::BvhObject& b)
+    {
+        return a.HasSameHierarchy(b) && testutil::has_same_channels(a, b) && a.frames() == b.frames() &&
+               a.frame_time() == b.frame_time() && testutil::max_abs_difference(a.motion(), b.motion()) == 0.0;
+    }
+
+    bool throws_runtime_error(const std::string& file_path, const bvh11::LoadOptions& options)
+    {
+        try
+        {
+            const bvh11::BvhObject bvh(file_path, options);
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string file_path = argv[i];
+        std::cout << file_path << std::endl;
+
+        const bvh11::BvhObject text_object(file_path);
+
+        const testutil::TemporaryFile binary_file("binary_test.bvhb");
+        text_object.WriteBinaryFile(binary_file.path());
+
+        // Loading the binary file, either through a stream or a memory mapping, gives exactly the same data
+        for (const bool use_memory_mapping : {false, true})
+        {
+            bvh11::LoadOptions options;
+            options.format             = bvh11::FileFormat::binary;
+            options.use_memory_mapping = use_memory_mapping;
+
+            const bvh11::BvhObject binary_object(binary_file.path(), options);
+            TESTUTIL_CHECK(has_same_data(binary_object, text_object));
+
+            // Writing the binary object as text gives the same data as the text file
+            const testutil::TemporaryFile text_file("binary_test.bvh");
+            binary_object.WriteBvhFile(text_file.path());
+            TESTUTIL_CHECK(has_same_data(bvh11::BvhObject(text_file.path()), text_object));
+        }
+
+        // Truncated files and text files are rejected instead of being misread
+        std::ifstream     ifs(binary_file.path(), std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+        const testutil::TemporaryFile truncated_file("binary_test_truncated.bvhb");
+        std::ofstream(truncated_file.path(), std::ios::binary) << contents.substr(0, contents.size() - 1);
+
+        for (const bool use_memory_mapping : {false, true})
+        {
+            bvh11::LoadOptions options;
+            options.format             = bvh11::FileFormat::binary;
+            options.use_memory_mapping = use_memory_mapping;
+
+            TESTUTIL_CHECK(throws_runtime_error(truncated_file.path(), options));
+            TESTUTIL_CHECK(throws_runtime_error(file_path, options));
+        }
+    }
+
+    return testutil::report();
+}
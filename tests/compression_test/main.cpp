@@ -0,0 +1,115 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/compressed-motion.hpp>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /// \brief Compute the positions of all the joints and the end sites at all the frames joint by joint through
+    ///        GetTransformation, independently of the error measurement of the compression.
+    std::vector<Eigen::Vector3d> compute_all_positions(const bvh11::BvhObject& bvh)
+    {
+        const auto                   joints = bvh.GetJointList();
+        std::vector<Eigen::Vector3d> positions;
+        for (int frame = 0; frame < bvh.frames(); ++frame)
+        {
+            for (const auto& joint : joints)
+            {
+                const Eigen::Affine3d transform = bvh.GetTransformation(joint, frame);
+                positions.push_back(transform.translation());
+                if (joint->has_end_site())
+                {
+                    positions.push_back(transform * joint->end_site());
+                }
+            }
+        }
+        return positions;
+    }
+
+    /// \return The largest distance between the corresponding positions, or infinity if the sizes differ.
+    double max_distance(const std::vector<Eigen::Vector3d>& a, const std::vector<Eigen::Vector3d>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        double distance = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            distance = std::max(distance, (a[i] - b[i]).norm());
+        }
+        return distance;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string file_path = argv[i];
+        std::cout << file_path << std::endl;
+
+        const bvh11::BvhObject             original(file_path);
+        const std::vector<Eigen::Vector3d> original_positions = compute_all_positions(original);
+
+        for (const bool use_quaternions : {false, true})
+        {
+            for (const double max_position_error : {0.1, 0.01})
+            {
+                bvh11::CompressionOptions options;
+                options.max_position_error = max_position_error;
+                options.use_quaternions    = use_quaternions;
+
+                const bvh11::CompressedMotion compressed(original, options);
+                TESTUTIL_CHECK(compressed.frames() == original.frames());
+                TESTUTIL_CHECK(compressed.num_channels() == static_cast<int>(original.channels().size()));
+                TESTUTIL_CHECK(compressed.max_measured_error() <= max_position_error);
+
+                // Sequential decompression reuses the previous frame for choosing the Euler angles
+                const Eigen::MatrixXd sequential = compressed.Decompress();
+
+                // The error recomputed from the decompressed channels stays within the bound
+                bvh11::BvhObject sequential_object(file_path);
+                sequential_object.mutable_motion() = sequential;
+
+                const std::vector<Eigen::Vector3d> sequential_positions = compute_all_positions(sequential_object);
+                TESTUTIL_CHECK(max_distance(sequential_positions, original_positions) <= max_position_error + 1e-9);
+
+                // Random access, alternately into a fresh vector and into the vector of an unrelated frame
+                std::vector<int> frames(compressed.frames());
+                std::iota(frames.begin(), frames.end(), 0);
+                std::shuffle(frames.begin(), frames.end(), std::mt19937(0));
+
+                Eigen::MatrixXd random_access(compressed.frames(), compressed.num_channels());
+                Eigen::VectorXd values;
+                for (std::size_t k = 0; k < frames.size(); ++k)
+                {
+                    if (k % 2 == 0)
+                    {
+                        values.resize(0);
+                    }
+                    compressed.DecompressFrame(frames[k], values);
+                    random_access.row(frames[k]) = values.transpose();
+                }
+
+                // Euler angles decoded from quaternions may be a different but equivalent set of angles, so they are
+                // compared by the poses; channel tracks are decoded independently of the output vector
+                bvh11::BvhObject random_access_object(file_path);
+                random_access_object.mutable_motion() = random_access;
+
+                TESTUTIL_CHECK(max_distance(compute_all_positions(random_access_object), sequential_positions) <=
+                               1e-9);
+                if (!use_quaternions)
+                {
+                    TESTUTIL_CHECK(testutil::max_abs_difference(random_access, sequential) == 0.0);
+                }
+            }
+        }
+    }
+
+    return testutil::report();
+}
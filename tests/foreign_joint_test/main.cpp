@@ -0,0 +1,76 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+    // Joints of another object are evaluated channel by channel, which rounds differently from the kernels
+    constexpr double tolerance = 1e-9;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string file_path = argv[i];
+        std::cout << file_path << std::endl;
+
+        // Two loads of the same file have equivalent but not shared hierarchies
+        const bvh11::BvhObject bvh(file_path);
+        const bvh11::BvhObject other(file_path);
+        TESTUTIL_CHECK(bvh.HasSameHierarchy(other) && bvh.skeleton() != other.skeleton());
+
+        const auto joints       = bvh.GetJointList();
+        const auto other_joints = other.GetJointList();
+
+        for (int frame = 0; frame < bvh.frames(); frame += std::max(1, bvh.frames() / 7))
+        {
+            double relative_difference = 0.0;
+            double global_difference   = 0.0;
+            for (std::size_t j = 0; j < joints.size(); ++j)
+            {
+                relative_difference = std::max(
+                    relative_difference,
+                    testutil::max_abs_difference(bvh.GetTransformationRelativeToParent(other_joints[j], frame).matrix(),
+                                                 bvh.GetTransformationRelativeToParent(joints[j], frame).matrix()));
+                global_difference =
+                    std::max(global_difference,
+                             testutil::max_abs_difference(bvh.GetTransformation(other_joints[j], frame).matrix(),
+                                                          bvh.GetTransformation(joints[j], frame).matrix()));
+            }
+            TESTUTIL_CHECK(relative_difference <= tolerance);
+            TESTUTIL_CHECK(global_difference <= tolerance);
+        }
+
+        // Lookups of the index do not fall back, and joints whose channels do not fit this object are rejected
+        bool is_index_rejected = false;
+        try
+        {
+            bvh.GetJointIndex(other_joints.back());
+        }
+        catch (const std::invalid_argument&)
+        {
+            is_index_rejected = true;
+        }
+        TESTUTIL_CHECK(is_index_rejected);
+
+        const auto stray_joint = std::make_shared<bvh11::Joint>("Stray", nullptr);
+        for (int k = 0; k < 3; ++k)
+        {
+            stray_joint->AssociateChannel(static_cast<int>(bvh.channels().size()) + k);
+        }
+
+        bool is_joint_rejected = false;
+        try
+        {
+            bvh.GetTransformation(stray_joint, 0);
+        }
+        catch (const std::invalid_argument&)
+        {
+            is_joint_rejected = true;
+        }
+        TESTUTIL_CHECK(is_joint_rejected);
+    }
+
+    return testutil::report();
+}
@@ -0,0 +1,146 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/library.hpp>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<std::string> read_lines(const std::string& file_path)
+    {
+        std::ifstream            ifs(file_path);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(ifs, line);)
+        {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    void write_lines(const std::string& file_path, const std::vector<std::string>& lines)
+    {
+        std::ofstream ofs(file_path);
+        for (const std::string& line : lines)
+        {
+            ofs << line << '\n';
+        }
+    }
+
+    /// \return The message of the std::runtime_error thrown by loading the file, or an empty string.
+    std::string get_load_error(const std::string& file_path, int num_threads)
+    {
+        bvh11::LoadOptions options;
+        options.num_threads = num_threads;
+        try
+        {
+            const bvh11::BvhObject bvh(file_path, options);
+        }
+        catch (const std::runtime_error& error)
+        {
+            return error.what();
+        }
+        return "";
+    }
+
+    bool begins_with(const std::string& text, const std::string& prefix)
+    {
+        return text.compare(0, prefix.size(), prefix) == 0;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string file_path = argv[i];
+        std::cout << file_path << std::endl;
+
+        const std::vector<std::string> lines = read_lines(file_path);
+
+        std::size_t frame_time_index = 0;
+        while (frame_time_index < lines.size() && !begins_with(lines[frame_time_index], "Frame Time:"))
+        {
+            ++frame_time_index;
+        }
+        TESTUTIL_CHECK(frame_time_index + 2 < lines.size());
+        if (frame_time_index + 2 >= lines.size())
+        {
+            continue;
+        }
+
+        // A malformed value in the middle of the frames is reported with its line number, also by parallel parsing
+        {
+            const std::size_t line_index = frame_time_index + 1 + (lines.size() - frame_time_index - 1) / 2;
+
+            std::vector<std::string> malformed_lines = lines;
+            malformed_lines[line_index]              = "abc " + malformed_lines[line_index];
+
+            const testutil::TemporaryFile malformed_file("parse_error_test_value.bvh");
+            write_lines(malformed_file.path(), malformed_lines);
+
+            const std::string expected = "Line " + std::to_string(line_index + 1) + ":";
+            for (const int num_threads : {1, 4})
+            {
+                const std::string message = get_load_error(malformed_file.path(), num_threads);
+                TESTUTIL_CHECK(begins_with(message, expected));
+            }
+        }
+
+        // Missing frames and a truncated hierarchy are reported instead of being read past the end
+        {
+            const std::vector<std::string> truncated_lines(lines.begin(), lines.end() - 1);
+
+            const testutil::TemporaryFile truncated_file("parse_error_test_frames.bvh");
+            write_lines(truncated_file.path(), truncated_lines);
+            TESTUTIL_CHECK(!get_load_error(truncated_file.path(), 1).empty());
+            TESTUTIL_CHECK(!get_load_error(truncated_file.path(), 4).empty());
+
+            const std::vector<std::string> hierarchy_lines(lines.begin(), lines.begin() + frame_time_index / 2);
+            write_lines(truncated_file.path(), hierarchy_lines);
+            TESTUTIL_CHECK(!get_load_error(truncated_file.path(), 1).empty());
+        }
+    }
+
+    TESTUTIL_CHECK(!get_load_error("parse_error_test_nonexistent.bvh", 1).empty());
+
+    // Batch loading reports malformed files per clip, and clips whose hierarchy text is already known (here, the
+    // same files twice) are equal to direct loads
+    if (argc >= 2)
+    {
+        const testutil::TemporaryFile malformed_file("parse_error_test_library.bvh");
+        write_lines(malformed_file.path(), {"HIERARCHY", "ROOT Hips", "{", "}"});
+
+        std::vector<std::string> file_paths(argv + 1, argv + argc);
+        file_paths.insert(file_paths.end(), argv + 1, argv + argc);
+        file_paths.push_back(malformed_file.path());
+
+        // Both with a memory mapping and with the whole file read into memory
+        for (const bool use_memory_mapping : {false, true})
+        {
+            bvh11::LoadOptions options;
+            options.use_memory_mapping = use_memory_mapping;
+
+            const bvh11::BvhLibrary library(file_paths, options);
+            for (int index = 0; index + 1 < library.size(); ++index)
+            {
+                TESTUTIL_CHECK(library.is_loaded(index));
+                if (!library.is_loaded(index))
+                {
+                    continue;
+                }
+
+                const bvh11::BvhObject direct(library.file_path(index));
+                TESTUTIL_CHECK(library.clip(index)->HasSameHierarchy(direct));
+                TESTUTIL_CHECK(testutil::max_abs_difference(library.clip(index)->motion(), direct.motion()) == 0.0);
+            }
+            TESTUTIL_CHECK(library.num_hierarchies() <= argc - 1);
+            TESTUTIL_CHECK(!library.is_loaded(library.size() - 1));
+            TESTUTIL_CHECK(begins_with(library.error_message(library.size() - 1), "Line "));
+        }
+    }
+
+    return testutil::report();
+}
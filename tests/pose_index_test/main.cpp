@@ -0,0 +1,157 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/motion-database.hpp>
+#include <bvh11/pose-index.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    bool has_same_results(const std::vector<bvh11::NearestFrame>& a, const std::vector<bvh11::NearestFrame>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].frame != b[i].frame || a[i].squared_distance != b[i].squared_distance)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Overwrite a 32-bit value of the file and return whether loading it throws std::runtime_error.
+    bool is_corruption_rejected(const std::string& contents, std::size_t position, std::int32_t value)
+    {
+        std::string corrupted = contents;
+        std::memcpy(&corrupted[position], &value, sizeof(value));
+
+        const testutil::TemporaryFile corrupted_file("pose_index_test_corrupted.idx");
+        std::ofstream(corrupted_file.path(), std::ios::binary) << corrupted;
+        try
+        {
+            const bvh11::PoseIndex index(corrupted_file.path());
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // Use the clips that have the same hierarchy as the first one
+    std::vector<std::shared_ptr<const bvh11::BvhObject>> clips;
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto clip = std::make_shared<const bvh11::BvhObject>(argv[i]);
+        if (clips.empty() || clip->HasSameHierarchy(*clips.front()))
+        {
+            clips.push_back(clip);
+        }
+    }
+    TESTUTIL_CHECK(!clips.empty());
+    if (clips.empty())
+    {
+        return testutil::report();
+    }
+
+    bvh11::MotionDatabase database(clips);
+
+    bvh11::FeatureOptions feature_options;
+    for (int joint_index = 1; joint_index < static_cast<int>(clips.front()->GetJointList().size()); joint_index += 4)
+    {
+        feature_options.joint_indices.push_back(joint_index);
+    }
+    database.ComputeFeatures(feature_options);
+
+    // Add the clips one by one, so that the index has several trees
+    bvh11::PoseIndex index(database.num_features());
+    for (int clip_index = 0; clip_index < database.num_clips(); ++clip_index)
+    {
+        const int frame_begin = database.clip_frame_begin(clip_index);
+        const int frame_end   = database.clip_frame_end(clip_index);
+        index.AddFrames(database.features().middleRows(frame_begin, frame_end - frame_begin), frame_begin);
+    }
+    TESTUTIL_CHECK(index.size() == database.num_frames());
+
+    // Queries near the frames of the database
+    constexpr int                      num_queries = 200;
+    std::mt19937                       engine(0);
+    std::uniform_int_distribution<int> frame_distribution(0, database.num_frames() - 1);
+    std::normal_distribution<double>   noise_distribution(0.0, 0.05);
+    Eigen::MatrixXd                    queries(num_queries, database.num_features());
+    for (int i = 0; i < num_queries; ++i)
+    {
+        queries.row(i) = database.features().row(frame_distribution(engine));
+        for (int k = 0; k < database.num_features(); ++k)
+        {
+            queries(i, k) += noise_distribution(engine);
+        }
+    }
+
+    // The exact search finds frames as near as brute force, and the approximate search never finds nearer ones
+    bvh11::PoseSearchOptions approximate_options;
+    approximate_options.max_leaf_visits = 4;
+
+    std::vector<bvh11::NearestFrame> exact_results;
+    std::vector<bvh11::NearestFrame> approximate_results;
+    index.FindNearestFrames(queries, exact_results);
+    index.FindNearestFrames(queries, approximate_results, approximate_options);
+
+    for (int i = 0; i < num_queries; ++i)
+    {
+        const Eigen::VectorXd     query       = queries.row(i).transpose();
+        const bvh11::NearestFrame brute_force = database.FindNearestFrame(query);
+
+        TESTUTIL_CHECK(std::abs(exact_results[i].squared_distance - brute_force.squared_distance) <=
+                       1e-9 * (1.0 + brute_force.squared_distance));
+        TESTUTIL_CHECK(approximate_results[i].squared_distance >= exact_results[i].squared_distance);
+        TESTUTIL_CHECK(0 <= approximate_results[i].frame && approximate_results[i].frame < database.num_frames());
+
+        const bvh11::NearestFrame single = index.FindNearestFrame(query);
+        TESTUTIL_CHECK(single.frame == exact_results[i].frame);
+    }
+
+    // Writing and reloading the index gives exactly the same results
+    const testutil::TemporaryFile index_file("pose_index_test.idx");
+    index.WriteFile(index_file.path());
+
+    const bvh11::PoseIndex reloaded(index_file.path());
+    TESTUTIL_CHECK(reloaded.num_features() == index.num_features());
+    TESTUTIL_CHECK(reloaded.num_trees() == index.num_trees());
+    TESTUTIL_CHECK(reloaded.size() == index.size());
+
+    std::vector<bvh11::NearestFrame> reloaded_exact_results;
+    std::vector<bvh11::NearestFrame> reloaded_approximate_results;
+    reloaded.FindNearestFrames(queries, reloaded_exact_results);
+    reloaded.FindNearestFrames(queries, reloaded_approximate_results, approximate_options);
+    TESTUTIL_CHECK(has_same_results(reloaded_exact_results, exact_results));
+    TESTUTIL_CHECK(has_same_results(reloaded_approximate_results, approximate_results));
+
+    // Corrupt nodes of the first tree, whose node array begins at the first 64-byte boundary after the header and the
+    // sizes of the tree; a node is split_value (8 bytes), split_dimension, right_child, begin, and end
+    std::ifstream     ifs(index_file.path(), std::ios::binary);
+    const std::string contents((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    constexpr std::size_t root_node_position = 64;
+    TESTUTIL_CHECK(is_corruption_rejected(contents, root_node_position + 8, 1000000));
+    TESTUTIL_CHECK(is_corruption_rejected(contents, root_node_position + 20, 1 << 30));
+    TESTUTIL_CHECK(is_corruption_rejected(contents, root_node_position + 16, -5));
+    TESTUTIL_CHECK(is_corruption_rejected(contents, 20, 1 << 30));
+
+    return testutil::report();
+}
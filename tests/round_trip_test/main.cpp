@@ -0,0 +1,64 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+    std::string read_file(const std::string& file_path)
+    {
+        std::ifstream ifs(file_path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string file_path = argv[i];
+        std::cout << file_path << std::endl;
+
+        const bvh11::BvhObject original(file_path);
+
+        // Parse -> write -> parse gives exactly the same data with the default options
+        const testutil::TemporaryFile written_file("round_trip_test_written.bvh");
+        original.WriteBvhFile(written_file.path());
+
+        const bvh11::BvhObject reloaded(written_file.path());
+        TESTUTIL_CHECK(reloaded.HasSameHierarchy(original));
+        TESTUTIL_CHECK(testutil::has_same_channels(reloaded, original));
+        TESTUTIL_CHECK(reloaded.frames() == original.frames());
+        TESTUTIL_CHECK(reloaded.frame_time() == original.frame_time());
+        TESTUTIL_CHECK(testutil::max_abs_difference(reloaded.motion(), original.motion()) == 0.0);
+
+        // Writing the reloaded object gives the same text, so the output is a fixed point
+        const testutil::TemporaryFile rewritten_file("round_trip_test_rewritten.bvh");
+        reloaded.WriteBvhFile(rewritten_file.path());
+        TESTUTIL_CHECK(read_file(rewritten_file.path()) == read_file(written_file.path()));
+
+        // Formatting the frames on many threads gives the same text as formatting them sequentially
+        bvh11::WriteOptions parallel_options;
+        parallel_options.num_threads = 4;
+
+        const testutil::TemporaryFile parallel_file("round_trip_test_parallel.bvh");
+        original.WriteBvhFile(parallel_file.path(), parallel_options);
+        TESTUTIL_CHECK(read_file(parallel_file.path()) == read_file(written_file.path()));
+
+        // Fixed decimal places are within half a unit of the last place (the offsets are rounded as well)
+        bvh11::WriteOptions fixed_options;
+        fixed_options.number_format  = bvh11::NumberFormat::fixed;
+        fixed_options.decimal_places = 3;
+
+        const testutil::TemporaryFile fixed_file("round_trip_test_fixed.bvh");
+        original.WriteBvhFile(fixed_file.path(), fixed_options);
+
+        const bvh11::BvhObject rounded(fixed_file.path());
+        TESTUTIL_CHECK(testutil::has_same_channels(rounded, original));
+        TESTUTIL_CHECK(rounded.frames() == original.frames());
+        TESTUTIL_CHECK(testutil::max_abs_difference(rounded.motion(), original.motion()) <= 0.5e-3 + 1e-9);
+    }
+
+    return testutil::report();
+}
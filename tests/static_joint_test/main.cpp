@@ -0,0 +1,126 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/clip-evaluator.hpp>
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    /// \return The largest difference between the transformations of all the joints at all the frames.
+    double max_transform_difference(const bvh11::TransformList& a, const bvh11::TransformList& b)
+    {
+        if (a.size() != b.size())
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        double difference = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            difference = std::max(difference, testutil::max_abs_difference(a[i].matrix(), b[i].matrix()));
+        }
+        return difference;
+    }
+
+    /// \brief Evaluate all the frames one by one.
+    bvh11::TransformList compute_all_transforms(const bvh11::BvhObject& bvh)
+    {
+        const std::size_t    num_joints = bvh.GetJointList().size();
+        bvh11::TransformList all_transforms(bvh.frames() * num_joints);
+        bvh11::TransformList transforms;
+        for (int frame = 0; frame < bvh.frames(); ++frame)
+        {
+            bvh.ComputeGlobalTransforms(frame, transforms);
+            std::copy(transforms.begin(), transforms.end(), all_transforms.begin() + frame * num_joints);
+        }
+        return all_transforms;
+    }
+
+    /// \brief Evaluate all the frames joint by joint through GetTransformation.
+    bvh11::TransformList compute_all_transforms_by_joint(const bvh11::BvhObject& bvh)
+    {
+        const auto           joints = bvh.GetJointList();
+        bvh11::TransformList all_transforms;
+        for (int frame = 0; frame < bvh.frames(); ++frame)
+        {
+            for (const auto& joint : joints)
+            {
+                all_transforms.push_back(bvh.GetTransformation(joint, frame));
+            }
+        }
+        return all_transforms;
+    }
+
+    bvh11::TransformList evaluate_clip(const bvh11::BvhObject& bvh, bvh11::ExecutionPolicy policy)
+    {
+        bvh11::ClipEvaluationOptions options;
+        options.policy      = policy;
+        options.num_threads = 4;
+        options.chunk_size  = 16;
+
+        bvh11::TransformList transforms;
+        bvh11::ClipEvaluator(bvh, options).Evaluate(transforms);
+        return transforms;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // Analyzed results match the dense ones exactly up to the rounding of a different evaluation order
+    constexpr double tolerance = 1e-12;
+
+    // The rotation cache converts Euler angles through quaternions, which rounds differently
+    constexpr double cache_tolerance = 1e-9;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string file_path = argv[i];
+        std::cout << file_path << std::endl;
+
+        bvh11::BvhObject bvh(file_path);
+
+        // Freeze the channels of every third joint, so that there are static joints besides the end effectors
+        const auto joints = bvh.GetJointList();
+        for (std::size_t j = 0; j < joints.size(); j += 3)
+        {
+            for (const int channel_index : joints[j]->associated_channels_indices())
+            {
+                Eigen::MatrixXd& motion = bvh.mutable_motion();
+                motion.col(channel_index).setConstant(motion(0, channel_index));
+            }
+        }
+
+        const bvh11::TransformList dense_transforms  = compute_all_transforms(bvh);
+        const bvh11::TransformList dense_by_joint    = compute_all_transforms_by_joint(bvh);
+        const Eigen::MatrixXd      dense_positions   = bvh.ComputeGlobalPositions(0, bvh.frames());
+        const bvh11::TransformList dense_clip        = evaluate_clip(bvh, bvh11::ExecutionPolicy::sequential);
+        const bvh11::TransformList dense_pooled_clip = evaluate_clip(bvh, bvh11::ExecutionPolicy::thread_pool);
+        const bvh11::TransformList dense_openmp_clip = evaluate_clip(bvh, bvh11::ExecutionPolicy::openmp);
+
+        TESTUTIL_CHECK(max_transform_difference(dense_by_joint, dense_transforms) <= tolerance);
+        TESTUTIL_CHECK(max_transform_difference(dense_clip, dense_transforms) == 0.0);
+        TESTUTIL_CHECK(max_transform_difference(dense_pooled_clip, dense_transforms) == 0.0);
+        TESTUTIL_CHECK(max_transform_difference(dense_openmp_clip, dense_transforms) == 0.0);
+
+        bvh.AnalyzeConstantChannels();
+        TESTUTIL_CHECK(bvh.has_constant_channel_analysis());
+        TESTUTIL_CHECK(std::count(bvh.static_joint_flags().begin(), bvh.static_joint_flags().end(), 1) >=
+                       static_cast<int>((joints.size() + 2) / 3));
+
+        TESTUTIL_CHECK(max_transform_difference(compute_all_transforms(bvh), dense_transforms) <= tolerance);
+        TESTUTIL_CHECK(max_transform_difference(compute_all_transforms_by_joint(bvh), dense_by_joint) <= tolerance);
+        TESTUTIL_CHECK(testutil::max_abs_difference(bvh.ComputeGlobalPositions(0, bvh.frames()), dense_positions) <=
+                       tolerance);
+        TESTUTIL_CHECK(max_transform_difference(evaluate_clip(bvh, bvh11::ExecutionPolicy::sequential),
+                                                dense_transforms) <= tolerance);
+        TESTUTIL_CHECK(max_transform_difference(evaluate_clip(bvh, bvh11::ExecutionPolicy::thread_pool),
+                                                dense_transforms) <= tolerance);
+
+        // The analysis and the rotation cache together
+        bvh.BuildRotationCache();
+        TESTUTIL_CHECK(max_transform_difference(compute_all_transforms(bvh), dense_transforms) <= cache_tolerance);
+        TESTUTIL_CHECK(max_transform_difference(evaluate_clip(bvh, bvh11::ExecutionPolicy::thread_pool),
+                                                dense_transforms) <= cache_tolerance);
+    }
+
+    return testutil::report();
+}
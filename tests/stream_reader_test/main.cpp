@@ -0,0 +1,116 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/stream-reader.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    /// \brief Check that the stream reader decodes the same values as the object for the options.
+    void check_stream_reader(const std::string&                file_path,
+                             const bvh11::BvhObject&           expected,
+                             const bvh11::StreamReaderOptions& options)
+    {
+        bvh11::BvhStreamReader reader(file_path, options);
+        TESTUTIL_CHECK(reader.frames() == expected.frames());
+        TESTUTIL_CHECK(reader.frame_time() == expected.frame_time());
+        if (reader.frames() != expected.frames())
+        {
+            return;
+        }
+
+        // Random access to single frames, which also evicts blocks when the cache is small
+        std::mt19937                       random_engine(0);
+        std::uniform_int_distribution<int> frame_distribution(0, expected.frames() - 1);
+        for (int i = 0; i < 200; ++i)
+        {
+            const int frame = frame_distribution(random_engine);
+            TESTUTIL_CHECK(testutil::max_abs_difference(reader.GetFrame(frame),
+                                                        expected.motion().row(frame).transpose()) == 0.0);
+            TESTUTIL_CHECK(reader.num_cached_frames() <= std::max(options.cache_capacity, options.index_interval));
+        }
+
+        // Ranges that start and end in the middle of blocks, and the whole clip
+        for (int i = 0; i < 50; ++i)
+        {
+            int frame_begin = frame_distribution(random_engine);
+            int frame_end   = frame_distribution(random_engine) + 1;
+            if (frame_begin > frame_end)
+            {
+                std::swap(frame_begin, frame_end);
+            }
+
+            const Eigen::MatrixXd range = reader.ReadFrameRange(frame_begin, frame_end);
+            TESTUTIL_CHECK(testutil::max_abs_difference(
+                               range, expected.motion().middleRows(frame_begin, frame_end - frame_begin)) == 0.0);
+        }
+        TESTUTIL_CHECK(testutil::max_abs_difference(reader.ReadFrameRange(0, expected.frames()), expected.motion()) ==
+                       0.0);
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string file_path = argv[i];
+        std::cout << file_path << std::endl;
+
+        const bvh11::BvhObject expected(file_path);
+
+        // The same file without the new-line character at the end of the last frame line
+        std::ifstream     ifs(file_path, std::ios::binary);
+        const std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        const std::string trimmed_text = text.substr(0, text.find_last_not_of(" \t\r\n") + 1);
+
+        const testutil::TemporaryFile trimmed_file("stream_reader_test_trimmed.bvh");
+        std::ofstream(trimmed_file.path(), std::ios::binary) << trimmed_text;
+
+        // Intervals that divide the number of the frames or leave a partial last block, and small and large caches
+        for (const int index_interval : {1, 7, 16, expected.frames() + 1})
+        {
+            for (const int cache_capacity : {1, 64, expected.frames() + index_interval})
+            {
+                bvh11::StreamReaderOptions options;
+                options.index_interval = index_interval;
+                options.cache_capacity = cache_capacity;
+
+                check_stream_reader(file_path, expected, options);
+                check_stream_reader(trimmed_file.path(), expected, options);
+            }
+        }
+
+        // When everything is cached, the count covers the partial last block exactly
+        bvh11::StreamReaderOptions options;
+        options.index_interval = 7;
+        options.cache_capacity = expected.frames() + options.index_interval;
+
+        bvh11::BvhStreamReader reader(file_path, options);
+        reader.ReadFrameRange(0, reader.frames());
+        TESTUTIL_CHECK(reader.num_cached_frames() == reader.frames());
+
+        // A non-positive interval is rejected
+        for (const int index_interval : {0, -1})
+        {
+            bvh11::StreamReaderOptions invalid_options;
+            invalid_options.index_interval = index_interval;
+
+            bool has_thrown = false;
+            try
+            {
+                bvh11::BvhStreamReader invalid_reader(file_path, invalid_options);
+            }
+            catch (const std::invalid_argument&)
+            {
+                has_thrown = true;
+            }
+            TESTUTIL_CHECK(has_thrown);
+        }
+    }
+
+    return testutil::report();
+}
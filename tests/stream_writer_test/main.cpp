@@ -0,0 +1,114 @@
+#include <test-util.hpp>
+#include <bvh11.hpp>
+#include <bvh11/stream-writer.hpp>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    std::string read_file(const std::string& file_path)
+    {
+        std::ifstream ifs(file_path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string file_path = argv[i];
+        std::cout << file_path << std::endl;
+
+        const bvh11::BvhObject original(file_path);
+
+        // A small queue makes the producer wait for the background thread and wrap around the ring buffer
+        bvh11::StreamWriterOptions options;
+        options.queue_capacity = 16;
+
+        const testutil::TemporaryFile written_file("stream_writer_test_written.bvh");
+        {
+            bvh11::BvhStreamWriter writer(written_file.path(), original, options);
+
+            // Append the frames from another thread, one by one, as a live capture would
+            std::thread producer(
+                [&]() -> void
+                {
+                    for (int frame = 0; frame < original.frames(); ++frame)
+                    {
+                        writer.AppendFrame(Eigen::VectorXd(original.motion().row(frame).transpose()));
+                    }
+                });
+            producer.join();
+
+            TESTUTIL_CHECK(writer.num_appended_frames() == original.frames());
+            TESTUTIL_CHECK(!writer.has_failed());
+
+            bool has_thrown = false;
+            try
+            {
+                writer.Close();
+            }
+            catch (const std::runtime_error&)
+            {
+                has_thrown = true;
+            }
+            TESTUTIL_CHECK(!has_thrown);
+            TESTUTIL_CHECK(!writer.is_open());
+        }
+
+        // The placeholder of the number of the frames is patched in place
+        const std::string text = read_file(written_file.path());
+        TESTUTIL_CHECK(text.find("Frames: " + std::to_string(original.frames()) + " ") != std::string::npos);
+
+        // The default options round-trip the values exactly
+        const bvh11::BvhObject reloaded(written_file.path());
+        TESTUTIL_CHECK(reloaded.HasSameHierarchy(original));
+        TESTUTIL_CHECK(testutil::has_same_channels(reloaded, original));
+        TESTUTIL_CHECK(reloaded.frames() == original.frames());
+        TESTUTIL_CHECK(reloaded.frame_time() == original.frame_time());
+        TESTUTIL_CHECK(testutil::max_abs_difference(reloaded.motion(), original.motion()) == 0.0);
+    }
+
+    if (argc >= 2)
+    {
+        const bvh11::BvhObject original(argv[1]);
+
+        // A file that cannot be opened throws at construction
+        bool has_thrown = false;
+        try
+        {
+            bvh11::BvhStreamWriter writer("nonexistent-directory/stream_writer_test.bvh", original);
+        }
+        catch (const std::runtime_error&)
+        {
+            has_thrown = true;
+        }
+        TESTUTIL_CHECK(has_thrown);
+
+        // Writes to a full device fail, which is reported by Close (only on systems that have such a device)
+        if (std::ifstream("/dev/full").is_open())
+        {
+            bvh11::BvhStreamWriter writer("/dev/full", original);
+            writer.AppendFrames(original.motion());
+
+            has_thrown = false;
+            try
+            {
+                writer.Close();
+            }
+            catch (const std::runtime_error&)
+            {
+                has_thrown = true;
+            }
+            TESTUTIL_CHECK(has_thrown);
+            TESTUTIL_CHECK(writer.has_failed());
+            TESTUTIL_CHECK(!writer.is_open());
+        }
+    }
+
+    return testutil::report();
+}
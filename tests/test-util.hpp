@@ -0,0 +1,89 @@
+#ifndef BVH11_TEST_UTIL_HPP_
+#define BVH11_TEST_UTIL_HPP_
+
+#include <bvh11.hpp>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+
+/// \brief Check a condition and report it with its location if it does not hold; the test goes on to report all the
+///        failed checks at once.
+#define TESTUTIL_CHECK(condition) testutil::check((condition), #condition, __FILE__, __LINE__)
+
+namespace testutil
+{
+    inline int& get_num_failures()
+    {
+        static int num_failures = 0;
+        return num_failures;
+    }
+
+    inline void check(bool condition, const char* expression, const char* file, int line)
+    {
+        if (!condition)
+        {
+            ++get_num_failures();
+            std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+        }
+    }
+
+    /// \return The exit code of the test.
+    inline int report()
+    {
+        if (get_num_failures() == 0)
+        {
+            std::cout << "All checks passed." << std::endl;
+            return 0;
+        }
+        std::cerr << get_num_failures() << " check(s) failed." << std::endl;
+        return 1;
+    }
+
+    /// \return The largest absolute difference between the elements, or infinity if the sizes differ.
+    template <typename DerivedA, typename DerivedB>
+    double max_abs_difference(const Eigen::MatrixBase<DerivedA>& a, const Eigen::MatrixBase<DerivedB>& b)
+    {
+        if (a.rows() != b.rows() || a.cols() != b.cols())
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        return (a.rows() * a.cols() == 0) ? 0.0 : (a - b).cwiseAbs().maxCoeff();
+    }
+
+    /// \return Whether the channels have the same types and target joint names in the same order.
+    inline bool has_same_channels(const bvh11::BvhObject& a, const bvh11::BvhObject& b)
+    {
+        if (a.channels().size() != b.channels().size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.channels().size(); ++i)
+        {
+            if (a.channels()[i].type != b.channels()[i].type ||
+                a.channels()[i].target_joint->name() != b.channels()[i].target_joint->name())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Name of a temporary file in the working directory, removed when the object goes away.
+    class TemporaryFile
+    {
+    public:
+        explicit TemporaryFile(const std::string& file_path) : file_path_(file_path) {}
+        ~TemporaryFile() { std::remove(file_path_.c_str()); }
+
+        TemporaryFile(const TemporaryFile&)            = delete;
+        TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+        const std::string& path() const { return file_path_; }
+
+    private:
+        std::string file_path_;
+    };
+} // namespace testutil
+
+#endif